@@ -5,20 +5,66 @@
  * Uses platform-specific aligned allocation functions.
  */
 
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <new>
+#include <optional>
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <atomic>
 #include <cassert>
 #include <unordered_map>
 #include <map>
 #include <set>
+#include <span>
+#include <stdexcept>
 #include <list>
 #include <deque>
+#include <functional>
 #include <queue>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/uio.h>
+    #if __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #include <sys/syscall.h>
+    #endif
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 
 // ========== Cache Line Alignment ========== //
 // Use hardware-specific cache line size if available (C++17+)
@@ -28,6 +74,277 @@
 
 constexpr static size_t CACHE_LINE_SIZE = hardware_destructive_interference_size;
 
+// ========== Allocation Backends ========== //
+/**
+ * A backend supplies raw aligned memory to AlignedAllocator. Backends are stateless
+ * (static member functions), so allocators stay `is_always_equal`:
+ *
+ *   static void* allocate(std::size_t bytes, std::size_t alignment);   // throws std::bad_alloc
+ *   static void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept;
+ *   static constexpr const char* name;
+ *
+ * Optionally, for single-object allocations with a compile-time size:
+ *
+ *   template<std::size_t Alignment, std::size_t Bytes> static void* allocateFixed();
+ *   template<std::size_t Alignment, std::size_t Bytes> static void deallocateFixed(void* p) noexcept;
+ *
+ * `alignment` is always a power of two.
+ */
+
+/**
+ * Platform aligned allocation: posix_memalign (POSIX) or _aligned_malloc (Windows).
+ */
+struct SystemAlignedBackend {
+    static constexpr const char* name = "system";
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        void* ptr = nullptr;
+#if defined(_MSC_VER)
+        // Windows aligned allocation
+        ptr = _aligned_malloc(bytes, alignment);
+#else
+        // POSIX aligned allocation (alignment must be a multiple of sizeof(void*))
+        if (alignment < sizeof(void*)) alignment = sizeof(void*);
+        if (posix_memalign(&ptr, alignment, bytes) != 0) {
+            throw std::bad_alloc();
+        }
+#endif
+        // Verify allocation succeeded
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    static void deallocate(void* p, std::size_t, std::size_t) noexcept {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        free(p);  // free() works with posix_memalign allocations
+#endif
+    }
+};
+
+/**
+ * C++17 aligned operator new / sized aligned operator delete.
+ */
+struct NewAlignedBackend {
+    static constexpr const char* name = "operator-new";
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        return ::operator new(bytes, std::align_val_t{alignment});
+    }
+
+    static void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+        ::operator delete(p, bytes, std::align_val_t{alignment});
+    }
+};
+
+// ========== Allocation Tracing ========== //
+/**
+ * One allocator event in the binary trace (32 bytes, little-endian host order).
+ * File layout: TraceFileHeader followed by TraceRecords in per-thread batches;
+ * sort by timestampNs to get a global order.
+ */
+struct TraceRecord {
+    std::uint64_t timestampNs;   // Since recording started
+    std::uint64_t ptrId;         // Block address; matches an allocate with its deallocate
+    std::uint64_t size;          // Bytes
+    std::uint32_t threadId;      // Dense id, 0 = first thread that recorded
+    std::uint16_t alignmentLog2;
+    std::uint8_t op;             // TraceOp
+    std::uint8_t reserved;
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord is a fixed 32-byte on-disk format");
+
+enum class TraceOp : std::uint8_t {
+    Allocate = 0,
+    Deallocate = 1
+};
+
+struct TraceFileHeader {
+    char magic[8];               // "AATRACE1"
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+
+/**
+ * Process-wide recorder for AlignedAllocator events.
+ *
+ * Each thread appends to its own buffer and publishes the record count with a
+ * release store - no lock and no shared writes on the hot path. The buffer's
+ * mutex is only taken to write records out: by the owner when the buffer is
+ * full, by stop() and at thread exit. When recording is off the cost is one
+ * relaxed atomic load per allocation.
+ *
+ * Usage:
+ *   AllocationTraceRecorder::start("orders.aatrace");
+ *   ... run workload with AlignedAllocator<T, A, TracingBackend<>> ...
+ *   AllocationTraceRecorder::stop();
+ */
+class AllocationTraceRecorder {
+    static constexpr std::size_t kBufferRecords = 4096;
+
+    struct ThreadBuffer {
+        std::mutex lock;                     // Held while flushing (owner when full vs. stop())
+        std::uint32_t threadId = 0;
+        std::atomic<std::size_t> count{0};   // Records written; stored only by the owner, except the reset in flush()
+        std::size_t flushed = 0;             // Records already in the file; guarded by lock
+        TraceRecord* records = nullptr;
+
+        ThreadBuffer() {
+            records = static_cast<TraceRecord*>(std::malloc(kBufferRecords * sizeof(TraceRecord)));
+            threadId = instance().nextThreadId_.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(instance().registryLock_);
+            instance().buffers_.push_back(this);
+        }
+
+        ~ThreadBuffer() {
+            AllocationTraceRecorder& rec = instance();
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                rec.flush(*this);
+            }
+            std::lock_guard<std::mutex> guard(rec.registryLock_);
+            rec.buffers_.erase(std::find(rec.buffers_.begin(), rec.buffers_.end(), this));
+            std::free(records);
+        }
+    };
+
+public:
+    /**
+     * Opens `path`, writes the header and enables recording.
+     * @return false if the file cannot be opened or recording is already on
+     */
+    static bool start(const std::string& path) {
+        AllocationTraceRecorder& rec = instance();
+        std::lock_guard<std::mutex> guard(rec.fileLock_);
+        if (rec.file_) return false;
+        rec.file_ = std::fopen(path.c_str(), "wb");
+        if (!rec.file_) return false;
+
+        const TraceFileHeader header{{'A', 'A', 'T', 'R', 'A', 'C', 'E', '1'}, 1, sizeof(TraceRecord)};
+        std::fwrite(&header, sizeof(header), 1, rec.file_);
+        rec.epochNs_.store(steadyNowNs(), std::memory_order_relaxed);
+        rec.enabled_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Disables recording, flushes every thread's pending records and closes the file.
+     */
+    static void stop() {
+        AllocationTraceRecorder& rec = instance();
+        rec.enabled_.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> registry(rec.registryLock_);
+            for (ThreadBuffer* buffer : rec.buffers_) {
+                std::lock_guard<std::mutex> guard(buffer->lock);
+                rec.flush(*buffer);
+            }
+        }
+        std::lock_guard<std::mutex> guard(rec.fileLock_);
+        if (rec.file_) {
+            std::fclose(rec.file_);
+            rec.file_ = nullptr;
+        }
+    }
+
+    static bool enabled() noexcept {
+        return instance().enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Appends one event to the calling thread's buffer.
+     */
+    static void record(TraceOp op, const void* p, std::size_t bytes, std::size_t alignment) noexcept {
+        AllocationTraceRecorder& rec = instance();
+        thread_local ThreadBuffer buffer;
+        if (!buffer.records) return;
+
+        std::uint16_t log2 = 0;
+        while ((std::size_t{1} << log2) < alignment) ++log2;
+
+        // stop() only reads records below the published count, so the slot being written is ours
+        const std::size_t n = buffer.count.load(std::memory_order_relaxed);
+        buffer.records[n] = TraceRecord{
+            static_cast<std::uint64_t>(steadyNowNs() - rec.epochNs_.load(std::memory_order_acquire)),
+            static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p)),
+            bytes, buffer.threadId, log2, static_cast<std::uint8_t>(op), 0};
+        buffer.count.store(n + 1, std::memory_order_release);
+        if (n + 1 == kBufferRecords) {
+            std::lock_guard<std::mutex> guard(buffer.lock);
+            rec.flush(buffer);
+        }
+    }
+
+private:
+    static AllocationTraceRecorder& instance() noexcept {
+        static AllocationTraceRecorder rec;
+        return rec;
+    }
+
+    static std::int64_t steadyNowNs() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Writes the published, not yet written records. Caller holds buffer.lock.
+     * A full buffer is reset; its owner appends again only after this returns
+     * (it flushes a full buffer itself before its next record).
+     */
+    void flush(ThreadBuffer& buffer) noexcept {
+        const std::size_t n = buffer.count.load(std::memory_order_acquire);
+        if (n > buffer.flushed) {
+            std::lock_guard<std::mutex> guard(fileLock_);
+            if (file_) std::fwrite(buffer.records + buffer.flushed, sizeof(TraceRecord), n - buffer.flushed, file_);
+        }
+        buffer.flushed = n;
+        if (n == kBufferRecords) {
+            buffer.count.store(0, std::memory_order_relaxed);
+            buffer.flushed = 0;
+        }
+    }
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<std::uint32_t> nextThreadId_{0};
+    std::atomic<std::int64_t> epochNs_{0};  // steady_clock at start(); read by every record()
+    std::mutex fileLock_;
+    std::FILE* file_ = nullptr;
+    std::mutex registryLock_;
+    std::vector<ThreadBuffer*> buffers_;
+};
+
+/**
+ * Backend decorator that records every allocate/deallocate while
+ * AllocationTraceRecorder is running, then forwards to `Inner`.
+ */
+template<typename Inner = SystemAlignedBackend>
+struct TracingBackend {
+    static constexpr const char* name = "tracing";
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        void* p = Inner::allocate(bytes, alignment);
+        if (AllocationTraceRecorder::enabled()) {
+            AllocationTraceRecorder::record(TraceOp::Allocate, p, bytes, alignment);
+        }
+        return p;
+    }
+
+    static void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+        // Record before releasing so a reuse of the address is ordered after this event
+        if (AllocationTraceRecorder::enabled()) {
+            AllocationTraceRecorder::record(TraceOp::Deallocate, p, bytes, alignment);
+        }
+        Inner::deallocate(p, bytes, alignment);
+    }
+};
+
+// Backend used when AlignedAllocator is given none. Override at build time, e.g.
+// -DALIGNED_ALLOCATOR_DEFAULT_BACKEND=TracingBackend<> to trace every container.
+#ifndef ALIGNED_ALLOCATOR_DEFAULT_BACKEND
+    #define ALIGNED_ALLOCATOR_DEFAULT_BACKEND SystemAlignedBackend
+#endif
+
 // ========== AlignedAllocator ========== //
 /**
  * Cache-line aligned allocator to prevent false sharing in high-performance systems.
@@ -38,11 +355,13 @@ constexpr static size_t CACHE_LINE_SIZE = hardware_destructive_interference_size
  * - Thread-safe for concurrent allocations/deallocations
  * - Supports custom alignment requirements
  * - Compatible with all STL containers
+ * - Pluggable memory source (see Allocation Backends)
  * 
  * @tparam T Type of objects to allocate
  * @tparam Alignment Memory alignment boundary (defaults to cache line size)
+ * @tparam Backend Source of aligned memory (defaults to posix_memalign/_aligned_malloc)
  */
-template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE, typename Backend = ALIGNED_ALLOCATOR_DEFAULT_BACKEND>
 class AlignedAllocator {
 public:
     // Standard allocator typedefs
@@ -53,6 +372,14 @@ public:
     //All instances of this allocator are considered equal — so memory can be shared between them safely
     using is_always_equal = std::true_type;  // Stateless allocator (C++17)
 
+    AlignedAllocator() noexcept = default;
+
+    /**
+     * Converting constructor, required when containers rebind to their node types.
+     */
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, Backend>&) noexcept {}
+
     /**
      * Rebinds the allocator to another type U.
      * Required for STL containers that allocate internal node types.
@@ -67,115 +394,7924 @@ public:
      */
     template<typename U> //This defines a generic (template) struct — so we can rebind the allocator to any other type U.
     struct rebind { 
-        using other = AlignedAllocator<U, Alignment>; //This tells the STL: If you want to rebind this allocator to type U, then use AlignedAllocator<U, Alignment>.
+        using other = AlignedAllocator<U, Alignment, Backend>; //This tells the STL: If you want to rebind this allocator to type U, then use AlignedAllocator<U, Alignment, Backend>.
+    };
+
+    /**
+     * Allocates aligned memory block.
+     * @param n Number of elements to allocate
+     * @return Pointer to aligned memory
+     * @throws std::bad_alloc if allocation fails
+     */
+    T* allocate(std::size_t n) {
+        // Prevent integer overflow in size calculation
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+
+        void* ptr;
+        if constexpr (requires { Backend::template allocateFixed<kAlignment, sizeof(T)>(); }) {
+            // Node containers allocate one T at a time: use the backend's compile-time size class
+            ptr = (n == 1) ? Backend::template allocateFixed<kAlignment, sizeof(T)>()
+                           : Backend::allocate(n * sizeof(T), kAlignment);
+        } else {
+            ptr = Backend::allocate(n * sizeof(T), kAlignment);
+        }
+
+        // Debug check for correct alignment
+        assert(reinterpret_cast<uintptr_t>(ptr) % kAlignment == 0);
+
+        return static_cast<T*>(ptr);
+    }
+
+    /**
+     * Deallocates memory previously allocated by allocate().
+     * @param p Pointer to memory to deallocate
+     * @param n Number of elements (forwarded to the backend as a byte size)
+     */
+    void deallocate(T* p, std::size_t n) noexcept {
+        if constexpr (requires { Backend::template deallocateFixed<kAlignment, sizeof(T)>(p); }) {
+            if (n == 1) {
+                Backend::template deallocateFixed<kAlignment, sizeof(T)>(p);
+                return;
+            }
+        }
+        Backend::deallocate(p, n * sizeof(T), kAlignment);
+    }
+
+    /**
+     * Allocator equality comparison (C++20)
+     * Two allocators are equal if they have the same alignment requirements and backend
+     */
+    template<typename U, std::size_t A2, typename B2>
+    bool operator==(const AlignedAllocator<U, A2, B2>& other) const noexcept { 
+        return Alignment == A2 && std::is_same_v<Backend, B2>; 
+    }
+
+    /**
+     * Allocator inequality comparison (C++20)
+     */
+    template<typename U, std::size_t A2, typename B2>
+    bool operator!=(const AlignedAllocator<U, A2, B2>& other) const noexcept { 
+        return !(*this == other); 
+    }
+
+private:
+    // Over-aligned types keep their own, stricter alignment
+    static constexpr std::size_t kAlignment = alignof(T) > Alignment ? alignof(T) : Alignment;
+};
+
+// ========== Aligned Container Aliases ========== //
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+template<typename Key, typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedUnorderedMap = std::unordered_map<Key, T, std::hash<Key>, 
+                                              std::equal_to<Key>,
+                                              AlignedAllocator<std::pair<const Key, T>, Alignment>>;
+
+template<typename Key, typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedMap = std::map<Key, T, std::less<Key>,
+                           AlignedAllocator<std::pair<const Key, T>, Alignment>>;
+
+template<typename Key, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedSet = std::set<Key, std::less<Key>,
+                           AlignedAllocator<Key, Alignment>>;
+
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedList = std::list<T, AlignedAllocator<T, Alignment>>;
+
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedDeque = std::deque<T, AlignedAllocator<T, Alignment>>;
+
+// Heap buffer is aligned; short strings stay in the SSO buffer inside the object,
+// so wrap hot ones in CachePadded to keep that buffer on a single line
+template<typename CharT, typename Traits = std::char_traits<CharT>, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedBasicString = std::basic_string<CharT, Traits, AlignedAllocator<CharT, Alignment>>;
+
+using AlignedString = AlignedBasicString<char>;
+
+// Note: queue/stack adapters don't benefit from alignment directly
+// but their underlying container (deque/list) can use our allocator
+// Container can be swapped for AlignedBlockDeque (see AlignedBlockQueue)
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE, typename Container = AlignedDeque<T, Alignment>>
+using AlignedQueue = std::queue<T, Container>;
+
+// Binary heap on aligned storage; see AlignedPriorityQueue for the cache-line d-ary heap
+template<typename T, typename Compare = std::less<T>, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedBinaryHeap = std::priority_queue<T, AlignedVector<T, Alignment>, Compare>;
+
+// ========== Cache Padding ========== //
+/**
+ * Wraps a value so it occupies whole cache lines of its own.
+ * Use for per-thread counters, sequence numbers and indices that are written
+ * by one thread and would otherwise false-share with their neighbours.
+ */
+template<typename T>
+struct alignas(CACHE_LINE_SIZE) CachePadded {
+    T value{};
+};
+
+// ========== AlignedSeqLock ========== //
+/**
+ * Single-writer / multi-reader sequence lock publishing a consistent snapshot of T.
+ *
+ * Readers never block the writer: the writer bumps the sequence to odd, stores the
+ * payload and bumps it back to even. A reader copies the payload and retries if the
+ * sequence changed or was odd while it was copying.
+ *
+ * Layout: the sequence counter sits at the head of the first payload line, and the
+ * whole cell is cache-line aligned. A reader therefore pulls sequence + payload in
+ * a single line transfer (for payloads up to CACHE_LINE_SIZE - 8 bytes), and cells
+ * stored side by side in an array never share a line.
+ *
+ * The payload is kept as relaxed atomic words so concurrent copying is not a data
+ * race under the C++ memory model.
+ *
+ * @tparam T Trivially copyable payload type
+ */
+template<typename T>
+class alignas(CACHE_LINE_SIZE) AlignedSeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "AlignedSeqLock requires a trivially copyable payload");
+
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+public:
+    AlignedSeqLock() noexcept : AlignedSeqLock(T{}) {}
+
+    explicit AlignedSeqLock(const T& initial) noexcept {
+        storeWords(initial);
+    }
+
+    AlignedSeqLock(const AlignedSeqLock&) = delete;
+    AlignedSeqLock& operator=(const AlignedSeqLock&) = delete;
+
+    /**
+     * Publishes a new value. Must only be called from one writer thread at a time.
+     */
+    void store(const T& value) noexcept {
+        const std::uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);  // Odd sequence visible before payload
+        storeWords(value);
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Single read attempt.
+     * @param out Receives the snapshot on success
+     * @return false if a write was in progress or raced with the copy
+     */
+    bool tryLoad(T& out) const noexcept {
+        const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+
+        std::uint64_t buffer[kWords];
+        for (std::size_t i = 0; i < kWords; ++i) {
+            buffer[i] = words_[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);  // Payload reads complete before re-check
+        if (sequence_.load(std::memory_order_relaxed) != before) return false;
+
+        std::memcpy(&out, buffer, sizeof(T));
+        return true;
+    }
+
+    /**
+     * Spins until a consistent snapshot is obtained.
+     */
+    T load() const noexcept {
+        T out;
+        while (!tryLoad(out)) {
+            // Writer holds the cell only for the duration of a few stores
+        }
+        return out;
+    }
+
+    /**
+     * Current sequence number; changes by 2 per completed store().
+     */
+    std::uint64_t version() const noexcept {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+private:
+    void storeWords(const T& value) noexcept {
+        std::uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint64_t> sequence_{0};
+    std::atomic<std::uint64_t> words_[kWords];
+};
+
+// One published value per slot, e.g. latest trade per symbol
+template<typename T>
+using SnapshotCell = AlignedSeqLock<T>;
+
+// Array-of-cells storage; every cell starts on its own cache line
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using SnapshotCellArray = AlignedVector<SnapshotCell<T>, Alignment>;
+
+// ========== MulticastRing ========== //
+/**
+ * Cache-line padded sequence number used by MulticastRing producers and consumers.
+ * Starts at -1 ("nothing published / nothing consumed yet").
+ */
+class alignas(CACHE_LINE_SIZE) RingSequence {
+public:
+    std::int64_t load() const noexcept { return value_.load(std::memory_order_acquire); }
+    void store(std::int64_t v) noexcept { value_.store(v, std::memory_order_release); }
+
+private:
+    std::atomic<std::int64_t> value_{-1};
+};
+
+/**
+ * Disruptor-style single-producer multicast ring buffer.
+ *
+ * The producer writes each event once into a pre-allocated, aligned slot array and
+ * publishes it by advancing the cursor. Every consumer tracks its own padded
+ * sequence and reads the slot in place, so memory traffic does not grow with the
+ * number of consumers. Consumers can depend on other consumers (pipeline stages):
+ * a stage only sees an event after all of its dependencies have released it.
+ *
+ * Usage:
+ *   MulticastRing<TradeSnapshot> ring(1024);
+ *   auto& parse = ring.addConsumer();          // Stage 1
+ *   auto& risk  = ring.addConsumer({&parse});  // Stage 2, runs after parse
+ *
+ *   // Producer thread
+ *   std::int64_t hi = ring.claim(4);           // Batch claim 4 slots
+ *   for (auto s = hi - 3; s <= hi; ++s) ring[s] = ...;
+ *   ring.publish(hi);
+ *
+ *   // Consumer thread
+ *   std::int64_t avail = risk.waitFor(risk.next());
+ *   for (auto s = risk.next(); s <= avail; ++s) process(ring[s]);
+ *   risk.release(avail);
+ *
+ * Consumers must be added before the producer starts publishing.
+ *
+ * @tparam T Event type stored in the ring
+ * @tparam Alignment Alignment of the slot array
+ */
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+class MulticastRing {
+public:
+    class Consumer {
+    public:
+        /**
+         * Next sequence this consumer has not yet released.
+         */
+        std::int64_t next() const noexcept { return sequence_.load() + 1; }
+
+        /**
+         * Highest sequence readable right now (may be below next() if nothing is ready).
+         */
+        std::int64_t available() const noexcept {
+            std::int64_t avail = ring_->cursor_.load();
+            for (const Consumer* dep : dependencies_) {
+                avail = std::min(avail, dep->sequence_.load());
+            }
+            return avail;
+        }
+
+        /**
+         * Spins until `seq` is readable by this consumer.
+         * @return Highest readable sequence (>= seq), allowing batch processing
+         */
+        std::int64_t waitFor(std::int64_t seq) const noexcept {
+            std::int64_t avail;
+            for (unsigned spins = 0; (avail = available()) < seq; ++spins) {
+                if (spins > 1024) std::this_thread::yield();
+            }
+            return avail;
+        }
+
+        /**
+         * Marks every event up to and including `seq` as processed.
+         */
+        void release(std::int64_t seq) noexcept { sequence_.store(seq); }
+
+    private:
+        friend class MulticastRing;
+
+        RingSequence sequence_;
+        const MulticastRing* ring_ = nullptr;
+        std::vector<const Consumer*> dependencies_;
     };
 
-    /**
-     * Allocates aligned memory block.
-     * @param n Number of elements to allocate
-     * @return Pointer to aligned memory
-     * @throws std::bad_alloc if allocation fails
-     */
-    T* allocate(std::size_t n) {
-        // Prevent integer overflow in size calculation
-        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
-            throw std::bad_alloc();
-        }
+    /**
+     * @param capacity Number of slots, must be a power of two
+     */
+    explicit MulticastRing(std::size_t capacity)
+        : slots_(capacity), mask_(static_cast<std::int64_t>(capacity) - 1) {
+        assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+    }
+
+    MulticastRing(const MulticastRing&) = delete;
+    MulticastRing& operator=(const MulticastRing&) = delete;
+
+    /**
+     * Registers a consumer. Not thread-safe; call before publishing starts.
+     * @param dependsOn Consumers that must release an event before this one sees it
+     */
+    Consumer& addConsumer(std::initializer_list<const Consumer*> dependsOn = {}) {
+        consumers_.push_back(std::make_unique<Consumer>());
+        Consumer& c = *consumers_.back();
+        c.ring_ = this;
+        c.dependencies_.assign(dependsOn.begin(), dependsOn.end());
+        return c;
+    }
+
+    /**
+     * Claims the next `n` slots for writing (producer thread only).
+     * Waits while the slowest consumer is still reading the slots being reused.
+     * @return Highest claimed sequence; the batch is [result - n + 1, result]
+     */
+    std::int64_t claim(std::size_t n = 1) noexcept {
+        assert(n > 0 && n <= slots_.size());
+        const std::int64_t hi = nextSequence_ + static_cast<std::int64_t>(n) - 1;
+        const std::int64_t wrapPoint = hi - static_cast<std::int64_t>(slots_.size());
+
+        for (unsigned spins = 0; wrapPoint > cachedGatingSequence_; ++spins) {
+            cachedGatingSequence_ = minimumConsumerSequence();
+            if (spins > 1024) std::this_thread::yield();
+        }
+
+        nextSequence_ = hi + 1;
+        return hi;
+    }
+
+    /**
+     * Makes every claimed slot up to and including `seq` visible to consumers.
+     */
+    void publish(std::int64_t seq) noexcept { cursor_.store(seq); }
+
+    T& operator[](std::int64_t seq) noexcept { return slots_[static_cast<std::size_t>(seq & mask_)]; }
+    const T& operator[](std::int64_t seq) const noexcept { return slots_[static_cast<std::size_t>(seq & mask_)]; }
+
+    std::size_t capacity() const noexcept { return slots_.size(); }
+
+    /**
+     * Last published sequence (-1 before the first publish).
+     */
+    std::int64_t cursor() const noexcept { return cursor_.load(); }
+
+private:
+    std::int64_t minimumConsumerSequence() const noexcept {
+        std::int64_t minimum = cursor_.load();
+        for (const auto& c : consumers_) {
+            minimum = std::min(minimum, c->sequence_.load());
+        }
+        return minimum;
+    }
+
+    AlignedVector<T, Alignment> slots_;
+    const std::int64_t mask_;
+    std::vector<std::unique_ptr<Consumer>> consumers_;
+
+    RingSequence cursor_;                          // Read by every consumer
+    alignas(CACHE_LINE_SIZE) std::int64_t nextSequence_ = 0;  // Producer-private state
+    std::int64_t cachedGatingSequence_ = -1;
+};
+
+// ========== SpinLock ========== //
+/**
+ * Test-and-test-and-set spin lock on its own cache line.
+ * Meets the Lockable requirements, so it works with std::lock_guard.
+ * Intended for very short critical sections (free-list push/pop).
+ */
+class alignas(CACHE_LINE_SIZE) SpinLock {
+public:
+    void lock() noexcept {
+        for (;;) {
+            if (!locked_.exchange(true, std::memory_order_acquire)) return;
+            // Spin on a plain load so waiters share the line instead of bouncing it
+            for (unsigned spins = 0; locked_.load(std::memory_order_relaxed); ++spins) {
+                if (spins > 1024) std::this_thread::yield();
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        return !locked_.load(std::memory_order_relaxed) &&
+               !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> locked_{false};
+};
+
+// ========== AlignedObjectPool ========== //
+/**
+ * Recycling pool of fixed-size objects carved from AlignedAllocator chunks.
+ *
+ * Every object starts on its own `Alignment` boundary, so objects handed to
+ * different threads never share a cache line. Released objects go onto a free
+ * list and are reused before a new chunk is allocated; chunks are only returned
+ * to the allocator when the pool is destroyed.
+ *
+ * Thread-safe: create()/destroy() may be called concurrently.
+ *
+ * @tparam T Object type
+ * @tparam Alignment Alignment of every object slot (defaults to cache line size)
+ */
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedObjectPool {
+    union alignas(Alignment > alignof(T) ? Alignment : alignof(T)) Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+public:
+    /**
+     * @param slotsPerChunk Objects allocated from the backing allocator at a time
+     */
+    explicit AlignedObjectPool(std::size_t slotsPerChunk = 256)
+        : slotsPerChunk_(slotsPerChunk ? slotsPerChunk : 1) {}
+
+    AlignedObjectPool(const AlignedObjectPool&) = delete;
+    AlignedObjectPool& operator=(const AlignedObjectPool&) = delete;
+
+    /**
+     * Releases all chunks. Objects still alive are not destroyed.
+     */
+    ~AlignedObjectPool() {
+        AlignedAllocator<Slot, Alignment> alloc;
+        for (Slot* chunk : chunks_) {
+            alloc.deallocate(chunk, slotsPerChunk_);
+        }
+    }
+
+    /**
+     * Returns uninitialized, aligned storage for one T.
+     * @throws std::bad_alloc if a new chunk cannot be allocated
+     */
+    void* allocate() {
+        std::lock_guard<SpinLock> guard(lock_);
+        if (!freeList_) grow();
+        Slot* slot = freeList_;
+        freeList_ = slot->next;
+        return slot->storage;
+    }
+
+    /**
+     * Returns storage obtained from allocate() to the pool.
+     */
+    void deallocate(void* p) noexcept {
+        Slot* slot = reinterpret_cast<Slot*>(p);
+        std::lock_guard<SpinLock> guard(lock_);
+        slot->next = freeList_;
+        freeList_ = slot;
+    }
+
+    /**
+     * Allocates and constructs a T.
+     */
+    template<typename... Args>
+    T* create(Args&&... args) {
+        void* p = allocate();
+        try {
+            return new (p) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(p);
+            throw;
+        }
+    }
+
+    /**
+     * Destroys and recycles an object obtained from create().
+     */
+    void destroy(T* obj) noexcept {
+        obj->~T();
+        deallocate(obj);
+    }
+
+    /**
+     * Total number of slots owned by the pool (live + free).
+     */
+    std::size_t capacity() const noexcept {
+        std::lock_guard<SpinLock> guard(lock_);
+        return chunks_.size() * slotsPerChunk_;
+    }
+
+private:
+    void grow() {
+        AlignedAllocator<Slot, Alignment> alloc;
+        Slot* chunk = alloc.allocate(slotsPerChunk_);
+        try {
+            chunks_.push_back(chunk);
+        } catch (...) {
+            alloc.deallocate(chunk, slotsPerChunk_);
+            throw;
+        }
+        for (std::size_t i = 0; i < slotsPerChunk_; ++i) {
+            chunk[i].next = (i + 1 < slotsPerChunk_) ? &chunk[i + 1] : freeList_;
+        }
+        freeList_ = chunk;
+    }
+
+    const std::size_t slotsPerChunk_;
+    mutable SpinLock lock_;
+    Slot* freeList_ = nullptr;
+    std::vector<Slot*> chunks_;
+};
+
+// ========== IntrusiveMpscQueue ========== //
+/**
+ * Hook embedded in objects linked into an IntrusiveMpscQueue.
+ * Derive from it: `struct Order : MpscHook { ... };`
+ */
+struct MpscHook {
+    std::atomic<MpscHook*> mpscNext{nullptr};
+};
+
+/**
+ * Unbounded intrusive multi-producer / single-consumer queue (Vyukov).
+ *
+ * push() is wait-free: one exchange on the head plus one store. pop() is
+ * lock-free and only called by the consumer. The queue never allocates; pair it
+ * with AlignedObjectPool so nodes are recycled and cache-line aligned.
+ *
+ * Producer-side head, consumer-side tail and the stub node each sit on their
+ * own cache line, so producers only contend with each other on the head.
+ *
+ * pop() may briefly return nullptr while a producer is between its two steps,
+ * even though the queue is not empty; the element becomes visible once the
+ * producer finishes.
+ *
+ * @tparam T Element type, must derive from MpscHook
+ */
+template<typename T>
+class IntrusiveMpscQueue {
+    static_assert(std::is_base_of_v<MpscHook, T>, "IntrusiveMpscQueue elements must derive from MpscHook");
+
+public:
+    IntrusiveMpscQueue() noexcept : head_(&stub_), tail_(&stub_) {}
+
+    IntrusiveMpscQueue(const IntrusiveMpscQueue&) = delete;
+    IntrusiveMpscQueue& operator=(const IntrusiveMpscQueue&) = delete;
+
+    /**
+     * Enqueues an element. Safe to call from any number of threads.
+     */
+    void push(T* item) noexcept {
+        pushHook(static_cast<MpscHook*>(item));
+    }
+
+    /**
+     * Dequeues the oldest element (consumer thread only).
+     * @return nullptr if the queue is empty or a push is still in progress
+     */
+    T* pop() noexcept {
+        MpscHook* tail = tail_;
+        MpscHook* next = tail->mpscNext.load(std::memory_order_acquire);
+
+        if (tail == &stub_) {
+            if (!next) return nullptr;
+            tail_ = next;
+            tail = next;
+            next = next->mpscNext.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+
+        // tail is the last element; only dequeue it once the stub is linked behind it
+        if (tail != head_.load(std::memory_order_acquire)) return nullptr;
+
+        pushHook(&stub_);
+        next = tail->mpscNext.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+
+    /**
+     * True if no element is linked (consumer thread only; racy by nature).
+     */
+    bool empty() const noexcept {
+        return tail_ == &stub_ && stub_.mpscNext.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    void pushHook(MpscHook* node) noexcept {
+        node->mpscNext.store(nullptr, std::memory_order_relaxed);
+        MpscHook* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->mpscNext.store(node, std::memory_order_release);
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<MpscHook*> head_;  // Producers
+    alignas(CACHE_LINE_SIZE) MpscHook* tail_;               // Consumer
+    alignas(CACHE_LINE_SIZE) MpscHook stub_;
+};
+
+// ========== WorkStealingDeque ========== //
+/**
+ * Chase-Lev work-stealing deque (C11 formulation by Lê, Pop, Cohen, Zappa Nardelli).
+ *
+ * The owner thread pushes and takes at the bottom (LIFO); any other thread may
+ * steal from the top (FIFO). The circular buffer comes from AlignedAllocator and
+ * grows by doubling; retired buffers are kept until destruction because a
+ * concurrent stealer may still be reading them.
+ *
+ * top (written by stealers) and bottom (written by the owner) live on separate
+ * cache lines.
+ *
+ * @tparam T Trivially copyable element, typically a task pointer
+ * @tparam Alignment Alignment of the circular buffer
+ */
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque elements must be trivially copyable");
+
+    struct Buffer {
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::atomic<T>* slots;
+
+        T get(std::int64_t i) const noexcept { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, T v) noexcept { slots[i & mask].store(v, std::memory_order_relaxed); }
+    };
+
+public:
+    /**
+     * @param capacity Initial capacity, rounded up to a power of two
+     */
+    explicit WorkStealingDeque(std::size_t capacity = 1024) {
+        std::size_t pow2 = 1;
+        while (pow2 < capacity) pow2 <<= 1;
+        buffer_.store(newBuffer(static_cast<std::int64_t>(pow2)), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    ~WorkStealingDeque() {
+        for (Buffer* b : buffers_) {
+            AlignedAllocator<std::atomic<T>, Alignment>().deallocate(b->slots, static_cast<std::size_t>(b->capacity));
+            delete b;
+        }
+    }
+
+    /**
+     * Pushes at the bottom (owner thread only).
+     */
+    void push(T item) {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+        if (b - t > buf->capacity - 1) {
+            buf = grow(buf, b, t);
+        }
+        buf->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Pops from the bottom (owner thread only).
+     * @return false if the deque was empty or the last element was stolen
+     */
+    bool take(T& out) noexcept {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = buf->get(b);
+        if (t == b) {
+            // Last element: race against stealers for it
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * Steals from the top (any thread).
+     * @return false if the deque was empty or another thief won the race
+     */
+    bool steal(T& out) noexcept {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+
+        Buffer* buf = buffer_.load(std::memory_order_acquire);
+        out = buf->get(t);
+        return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /**
+     * Approximate number of queued elements.
+     */
+    std::size_t size() const noexcept {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+private:
+    Buffer* newBuffer(std::int64_t capacity) {
+        std::atomic<T>* slots = AlignedAllocator<std::atomic<T>, Alignment>().allocate(static_cast<std::size_t>(capacity));
+        for (std::int64_t i = 0; i < capacity; ++i) new (&slots[i]) std::atomic<T>();
+        buffers_.push_back(new Buffer{capacity, capacity - 1, slots});
+        return buffers_.back();
+    }
+
+    Buffer* grow(Buffer* old, std::int64_t b, std::int64_t t) {
+        Buffer* bigger = newBuffer(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        buffer_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> top_{0};     // Stealers
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> bottom_{0};  // Owner
+    alignas(CACHE_LINE_SIZE) std::atomic<Buffer*> buffer_{nullptr};
+    std::vector<Buffer*> buffers_;  // Owner-only; includes retired buffers
+};
+
+// ========== ForkJoinPool ========== //
+/**
+ * Minimal fork-join thread pool on top of WorkStealingDeque.
+ *
+ * invoke(a, b) forks `b` onto the calling worker's deque, runs `a` inline and then
+ * either runs `b` itself or, if it was stolen, keeps executing other tasks until
+ * the thief finishes it. Forked tasks live on the caller's stack, so fork/join
+ * never allocates.
+ *
+ * Tasks must not throw; an escaping exception terminates the program.
+ *
+ * Workers that find nothing to run spin briefly, then park on a condition
+ * variable; fork, run() and forEachWorker() wake them. Threads blocked in run()
+ * or forEachWorker() sleep on a condition variable until their tasks finish.
+ *
+ * Usage:
+ *   ForkJoinPool pool(4);
+ *   pool.parallelFor(0, prices.size(), 1024, [&](std::size_t i) { prices[i] *= 2; });
+ */
+class ForkJoinPool {
+    struct Task {
+        void (*body)(Task*) noexcept;
+        std::atomic<bool> done{false};
+        bool awaited = false;  // A thread outside the pool blocks on it in awaitTask()
+    };
+
+    template<typename F>
+    struct FunctionTask : Task {
+        F* fn;
+        explicit FunctionTask(F& f) noexcept : fn(&f) {
+            this->body = [](Task* self) noexcept { (*static_cast<FunctionTask*>(self)->fn)(); };
+        }
+    };
+
+    template<typename F>
+    struct IndexedTask : Task {
+        F* fn;
+        std::size_t index;
+        IndexedTask() noexcept {
+            this->body = [](Task* self) noexcept {
+                auto* t = static_cast<IndexedTask*>(self);
+                (*t->fn)(t->index);
+            };
+        }
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        WorkStealingDeque<Task*> deque;
+        std::atomic<Task*> pinned{nullptr};  // Task that must run on this worker
+        std::uint64_t rng;
+        std::thread thread;
+    };
+
+public:
+    /**
+     * @param threads Worker count (defaults to hardware concurrency)
+     */
+    explicit ForkJoinPool(unsigned threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+            workers_.back()->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_[i]->thread = std::thread([this, i] { workerLoop(*workers_[i]); });
+        }
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> guard(parkLock_);
+            stop_.store(true, std::memory_order_release);
+        }
+        parkCv_.notify_all();
+        for (auto& w : workers_) w->thread.join();
+    }
+
+    std::size_t size() const noexcept { return workers_.size(); }
+
+    /**
+     * Runs `f` inside the pool and blocks until it (and everything it forks) completes.
+     * Called from a worker thread, `f` simply runs inline.
+     */
+    template<typename F>
+    void run(F&& f) {
+        if (currentWorker() && currentPool() == this) {
+            f();
+            return;
+        }
+        FunctionTask<std::remove_reference_t<F>> task(f);
+        task.awaited = true;
+        {
+            std::lock_guard<std::mutex> guard(injectionLock_);
+            injected_.push_back(&task);
+        }
+        pendingInjected_.fetch_add(1, std::memory_order_release);
+        wakeWorkers(false);
+        awaitTask(task);
+    }
+
+    /**
+     * Runs `a` and `b` potentially in parallel and returns when both are done.
+     * Must be called from within run() (i.e. on a worker thread).
+     */
+    template<typename A, typename B>
+    void invoke(A&& a, B&& b) {
+        Worker* self = currentWorker();
+        if (!self || currentPool() != this) {
+            run([&] { invoke(a, b); });
+            return;
+        }
+
+        FunctionTask<std::remove_reference_t<B>> forked(b);
+        self->deque.push(&forked);
+        wakeWorkers(false);
+        a();
+
+        Task* top = nullptr;
+        if (self->deque.take(top)) {
+            assert(top == &forked);  // LIFO discipline: nested forks were joined already
+            b();
+            return;
+        }
+        // Stolen: help with other work until the thief completes it
+        while (!forked.done.load(std::memory_order_acquire)) {
+            if (!runOne(*self)) std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Calls f(i) for every i in [begin, end), splitting recursively down to `grain` indices.
+     */
+    template<typename F>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, F&& f) {
+        if (grain == 0) grain = 1;
+        run([&] { splitFor(begin, end, grain, f); });
+    }
+
+    /**
+     * Calls f(workerIndex) exactly once on every worker thread and waits for all of them.
+     *
+     * This is the static schedule: worker i always receives index i, so data a
+     * worker first touches (and therefore owns on a NUMA node) can be handed back
+     * to the same worker later. Called from one of this pool's workers it degrades
+     * to running every index inline. Concurrent external callers take turns.
+     */
+    template<typename F>
+    void forEachWorker(F&& f) {
+        using Fn = std::remove_reference_t<F>;
+        const std::size_t n = workers_.size();
+        if (currentWorker() && currentPool() == this) {
+            for (std::size_t i = 0; i < n; ++i) f(i);
+            return;
+        }
+
+        std::unique_ptr<IndexedTask<Fn>[]> tasks(new IndexedTask<Fn>[n]);
+        std::lock_guard<std::mutex> guard(pinnedLock_);  // One pinned task per worker at a time
+        for (std::size_t i = 0; i < n; ++i) {
+            tasks[i].fn = &f;
+            tasks[i].index = i;
+            tasks[i].awaited = true;
+            workers_[i]->pinned.store(&tasks[i], std::memory_order_release);
+        }
+        wakeWorkers(true);
+        for (std::size_t i = 0; i < n; ++i) awaitTask(tasks[i]);
+    }
+
+private:
+    template<typename F>
+    void splitFor(std::size_t begin, std::size_t end, std::size_t grain, F& f) {
+        if (end - begin <= grain) {
+            for (std::size_t i = begin; i < end; ++i) f(i);
+            return;
+        }
+        const std::size_t mid = begin + (end - begin) / 2;
+        invoke([&] { splitFor(begin, mid, grain, f); },
+               [&] { splitFor(mid, end, grain, f); });
+    }
+
+    static Worker*& currentWorker() noexcept {
+        thread_local Worker* worker = nullptr;
+        return worker;
+    }
+
+    static ForkJoinPool*& currentPool() noexcept {
+        thread_local ForkJoinPool* pool = nullptr;
+        return pool;
+    }
+
+    void execute(Task* task) noexcept {
+        task->body(task);
+        if (!task->awaited) {
+            task->done.store(true, std::memory_order_release);
+            return;
+        }
+        // Set under the lock: the waiter may destroy the task as soon as it sees it done
+        {
+            std::lock_guard<std::mutex> guard(doneLock_);
+            task->done.store(true, std::memory_order_release);
+        }
+        doneCv_.notify_all();
+    }
+
+    // Blocks a thread outside the pool until `task` has run
+    void awaitTask(Task& task) noexcept {
+        for (unsigned spins = 0; spins < 64; ++spins) {
+            if (task.done.load(std::memory_order_acquire)) return;
+        }
+        std::unique_lock<std::mutex> guard(doneLock_);
+        doneCv_.wait(guard, [&] { return task.done.load(std::memory_order_acquire); });
+    }
+
+    /**
+     * Called after publishing work. The fence pairs with the one in park(): either
+     * this sees the sleeper, or the sleeper's re-scan sees the work.
+     */
+    void wakeWorkers(bool all) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+        {
+            std::lock_guard<std::mutex> guard(parkLock_);
+            wakeEpoch_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (all) {
+            parkCv_.notify_all();
+        } else {
+            parkCv_.notify_one();
+        }
+    }
+
+    void park(Worker& self) noexcept {
+        const std::uint64_t seen = wakeEpoch_.load(std::memory_order_relaxed);
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!runOne(self)) {  // Re-scan: work published before a waker could see us
+            std::unique_lock<std::mutex> guard(parkLock_);
+            parkCv_.wait(guard, [&] {
+                return stop_.load(std::memory_order_relaxed) || wakeEpoch_.load(std::memory_order_relaxed) != seen;
+            });
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Runs one task: pinned task first, then the local deque, a victim's deque or the injection queue.
+     */
+    bool runOne(Worker& self) noexcept {
+        Task* task = nullptr;
+        if (self.pinned.load(std::memory_order_relaxed)) {
+            execute(self.pinned.exchange(nullptr, std::memory_order_acquire));
+            return true;
+        }
+        if (self.deque.take(task)) {
+            execute(task);
+            return true;
+        }
+
+        // xorshift64 victim selection
+        self.rng ^= self.rng << 13;
+        self.rng ^= self.rng >> 7;
+        self.rng ^= self.rng << 17;
+        const std::size_t n = workers_.size();
+        const std::size_t start = static_cast<std::size_t>(self.rng % n);
+        for (std::size_t k = 0; k < n; ++k) {
+            Worker& victim = *workers_[(start + k) % n];
+            if (&victim != &self && victim.deque.steal(task)) {
+                execute(task);
+                return true;
+            }
+        }
+
+        if (pendingInjected_.load(std::memory_order_acquire) > 0) {
+            std::unique_lock<std::mutex> guard(injectionLock_, std::try_to_lock);
+            if (guard.owns_lock() && !injected_.empty()) {
+                task = injected_.back();
+                injected_.pop_back();
+                pendingInjected_.fetch_sub(1, std::memory_order_relaxed);
+                guard.unlock();
+                execute(task);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(Worker& self) noexcept {
+        currentWorker() = &self;
+        currentPool() = this;
+        for (unsigned idle = 0; !stop_.load(std::memory_order_acquire);) {
+            if (runOne(self)) {
+                idle = 0;
+            } else if (++idle > 256) {
+                park(self);
+                idle = 0;
+            } else if (idle > 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex injectionLock_;
+    std::vector<Task*> injected_;
+    std::mutex pinnedLock_;  // Serializes forEachWorker() callers
+    std::mutex parkLock_;
+    std::condition_variable parkCv_;
+    std::mutex doneLock_;
+    std::condition_variable doneCv_;  // Signals awaited tasks
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> pendingInjected_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<unsigned> sleepers_{0};
+    std::atomic<std::uint64_t> wakeEpoch_{0};  // Bumped under parkLock_ on every wake
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> stop_{false};
+};
+
+// ========== Parallel Algorithms ========== //
+/**
+ * Boundary granularity used to split aligned buffers between threads.
+ * CacheLine: partitions after the first start on a cache-line (or larger `Alignment`) boundary.
+ * Page: every partition after the first starts on a page boundary (use for
+ * first-touch placement); requires the buffer address, see AlignedPartitioner.
+ */
+enum class PartitionGranularity {
+    CacheLine,
+    Page
+};
+
+// Base page size; partitions at this granularity let each page be owned by one worker
+constexpr static size_t MEMORY_PAGE_SIZE = 4096;
+
+/**
+ * Splits [0, count) into `parts` contiguous ranges whose split points fall on a
+ * boundary (a cache line or Alignment, whichever is larger, or a page), so no
+ * two partitions share a cache line (or a page) and threads writing
+ * neighbouring partitions cannot false-share.
+ *
+ * Given the buffer address (`base`), split points are aligned to absolute
+ * addresses: the first partition absorbs the elements before the first
+ * boundary, so any buffer alignment works. Without it they are boundary
+ * multiples from the start of the buffer, which only lands on real boundaries
+ * if the buffer is aligned to one.
+ *
+ * @tparam T Element type
+ * @tparam Alignment Alignment of the underlying buffer (boundaries are never finer)
+ */
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedPartitioner {
+public:
+    AlignedPartitioner(std::size_t count, std::size_t parts,
+                       PartitionGranularity granularity = PartitionGranularity::CacheLine,
+                       const void* base = nullptr) noexcept
+        : count_(count), parts_(parts ? parts : 1) {
+        const std::size_t line = std::max(CACHE_LINE_SIZE, Alignment);
+        const std::size_t boundary = (granularity == PartitionGranularity::Page && MEMORY_PAGE_SIZE > line)
+                                   ? MEMORY_PAGE_SIZE : line;
+        // Smallest element count whose byte size is a multiple of the boundary
+        std::size_t a = boundary, b = sizeof(T);
+        while (b) { const std::size_t r = a % b; a = b; b = r; }
+        unit_ = boundary / a;
+
+        if (base) {
+            // First element that starts on a boundary (none within one unit: keep offsets from the start)
+            const auto address = reinterpret_cast<std::uintptr_t>(base);
+            for (std::size_t k = 0; k < unit_; ++k) {
+                if ((address + k * sizeof(T)) % boundary == 0) {
+                    lead_ = std::min(k, count_);
+                    break;
+                }
+            }
+        }
+
+        const std::size_t units = (count_ - lead_ + unit_ - 1) / unit_;
+        unitsPerPart_ = (units + parts_ - 1) / parts_;
+    }
+
+    std::size_t parts() const noexcept { return parts_; }
+
+    /**
+     * Elements per boundary unit (partition sizes are multiples of this, except the last).
+     */
+    std::size_t unit() const noexcept { return unit_; }
+
+    std::size_t begin(std::size_t part) const noexcept {
+        return part == 0 ? 0 : std::min(count_, lead_ + part * unitsPerPart_ * unit_);
+    }
+    std::size_t end(std::size_t part) const noexcept { return std::min(count_, lead_ + (part + 1) * unitsPerPart_ * unit_); }
+
+private:
+    std::size_t count_;
+    std::size_t parts_;
+    std::size_t unit_ = 1;
+    std::size_t lead_ = 0;  // Elements before the first absolute boundary (extra share of partition 0)
+    std::size_t unitsPerPart_ = 0;
+};
+
+/**
+ * Alignment guaranteed for the data of a contiguous container; partitions never
+ * split finer than it (nor than a cache line). Specialized for AlignedVector and
+ * FirstTouchArray.
+ */
+template<typename Container>
+struct ContainerAlignment {
+    static constexpr std::size_t value = alignof(typename Container::value_type);
+};
+
+template<typename T, std::size_t Alignment, typename Backend>
+struct ContainerAlignment<std::vector<T, AlignedAllocator<T, Alignment, Backend>>> {
+    static constexpr std::size_t value = Alignment;
+};
+
+template<typename Container>
+using ContainerPartitioner = AlignedPartitioner<typename Container::value_type,
+                                                ContainerAlignment<std::remove_const_t<Container>>::value>;
+
+/**
+ * Touches every page of freshly allocated, not yet written storage from the worker
+ * that owns it under the static schedule (page-granular partitions, worker i gets
+ * partition i). The OS places a page on the node of the thread that first writes
+ * it, so later parallel* calls with the same pool and PartitionGranularity::Page
+ * find their partition in local memory.
+ *
+ * Usage:
+ *   AlignedAllocator<double, MEMORY_PAGE_SIZE> alloc;
+ *   double* raw = alloc.allocate(n);
+ *   parallelFirstTouch(pool, raw, n);
+ *
+ * FirstTouchArray wraps this (plus parallel construction) for owning buffers.
+ */
+template<std::size_t Alignment = MEMORY_PAGE_SIZE, typename T>
+void parallelFirstTouch(ForkJoinPool& pool, T* data, std::size_t count) {
+    const AlignedPartitioner<T, Alignment> parts(count, pool.size(), PartitionGranularity::Page, data);
+    volatile unsigned char* bytes = reinterpret_cast<unsigned char*>(data);
+    pool.forEachWorker([&](std::size_t w) {
+        const std::size_t first = parts.begin(w) * sizeof(T);
+        const std::size_t last = parts.end(w) * sizeof(T);
+        for (std::size_t offset = first; offset < last; offset += MEMORY_PAGE_SIZE) {
+            bytes[offset] = 0;
+        }
+    });
+}
+
+/**
+ * Calls f(element) for every element. Partition i is always processed by worker i.
+ * Works on AlignedVector, FirstTouchArray or any contiguous container.
+ */
+template<typename Container, typename F>
+void parallelForEach(ForkJoinPool& pool, Container& v, F f,
+                     PartitionGranularity granularity = PartitionGranularity::CacheLine) {
+    const ContainerPartitioner<Container> parts(v.size(), pool.size(), granularity, std::data(v));
+    pool.forEachWorker([&](std::size_t w) {
+        for (std::size_t i = parts.begin(w); i < parts.end(w); ++i) f(v[i]);
+    });
+}
+
+/**
+ * out[i] = f(in[i]). A resizable `out` is grown to in.size() on the calling thread;
+ * otherwise it must already be large enough. Partitions follow out's address so
+ * writes never share a line across workers.
+ */
+template<typename In, typename Out, typename F>
+void parallelTransform(ForkJoinPool& pool, const In& in, Out& out, F f,
+                       PartitionGranularity granularity = PartitionGranularity::CacheLine) {
+    if constexpr (requires { out.resize(in.size()); }) {
+        if (out.size() < in.size()) out.resize(in.size());
+    }
+    assert(out.size() >= in.size());
+    const ContainerPartitioner<Out> parts(in.size(), pool.size(), granularity, std::data(out));
+    pool.forEachWorker([&](std::size_t w) {
+        for (std::size_t i = parts.begin(w); i < parts.end(w); ++i) out[i] = f(in[i]);
+    });
+}
+
+/**
+ * Reduces with an associative `op`. Per-worker partials live in CachePadded slots.
+ */
+template<typename Container, typename R, typename Op>
+R parallelReduce(ForkJoinPool& pool, const Container& v, R init, Op op,
+                 PartitionGranularity granularity = PartitionGranularity::CacheLine) {
+    const ContainerPartitioner<Container> parts(v.size(), pool.size(), granularity, std::data(v));
+    AlignedVector<CachePadded<R>> partials(parts.parts());
+    AlignedVector<CachePadded<bool>> used(parts.parts());
+
+    pool.forEachWorker([&](std::size_t w) {
+        std::size_t i = parts.begin(w);
+        const std::size_t e = parts.end(w);
+        if (i == e) return;
+        R acc = v[i++];
+        for (; i < e; ++i) acc = op(acc, v[i]);
+        partials[w].value = acc;
+        used[w].value = true;
+    });
+
+    for (std::size_t w = 0; w < parts.parts(); ++w) {
+        if (used[w].value) init = op(init, partials[w].value);
+    }
+    return init;
+}
+
+/**
+ * Inclusive prefix scan with an associative `op`; `out` may alias `in`.
+ * Two passes: per-partition totals into padded slots, then a local scan seeded
+ * with the prefix of the preceding partitions.
+ */
+template<typename In, typename Out, typename Op = std::plus<typename In::value_type>>
+void parallelInclusiveScan(ForkJoinPool& pool, const In& in, Out& out,
+                           Op op = Op{}, PartitionGranularity granularity = PartitionGranularity::CacheLine) {
+    using T = typename In::value_type;
+    if constexpr (requires { out.resize(in.size()); }) {
+        if (out.size() < in.size()) out.resize(in.size());
+    }
+    assert(out.size() >= in.size());
+    const ContainerPartitioner<Out> parts(in.size(), pool.size(), granularity, std::data(out));
+    AlignedVector<CachePadded<T>> totals(parts.parts());
+
+    pool.forEachWorker([&](std::size_t w) {
+        std::size_t i = parts.begin(w);
+        const std::size_t e = parts.end(w);
+        if (i == e) return;
+        T acc = in[i++];
+        for (; i < e; ++i) acc = op(acc, in[i]);
+        totals[w].value = acc;
+    });
+
+    // Exclusive prefix of partition totals (few entries, sequential)
+    AlignedVector<CachePadded<T>> offsets(parts.parts());
+    for (std::size_t w = 1; w < parts.parts(); ++w) {
+        offsets[w].value = (w == 1) ? totals[0].value : op(offsets[w - 1].value, totals[w - 1].value);
+    }
+
+    pool.forEachWorker([&](std::size_t w) {
+        std::size_t i = parts.begin(w);
+        const std::size_t e = parts.end(w);
+        if (i == e) return;
+        T acc = (w == 0) ? in[i] : op(offsets[w].value, in[i]);
+        out[i++] = acc;
+        for (; i < e; ++i) out[i] = acc = op(acc, in[i]);
+    });
+}
+
+/**
+ * Sorts each aligned partition on its worker, then merges neighbouring runs
+ * pairwise in parallel with fork-join.
+ */
+template<typename Container, typename Compare = std::less<typename Container::value_type>>
+void parallelSort(ForkJoinPool& pool, Container& v, Compare comp = Compare{},
+                  PartitionGranularity granularity = PartitionGranularity::CacheLine) {
+    const ContainerPartitioner<Container> parts(v.size(), pool.size(), granularity, std::data(v));
+    pool.forEachWorker([&](std::size_t w) {
+        std::sort(v.begin() + parts.begin(w), v.begin() + parts.end(w), comp);
+    });
+
+    for (std::size_t width = 1; width < parts.parts(); width *= 2) {
+        pool.parallelFor(0, (parts.parts() + 2 * width - 1) / (2 * width), 1, [&](std::size_t pair) {
+            const std::size_t lo = pair * 2 * width;
+            const std::size_t mid = std::min(lo + width, parts.parts());
+            const std::size_t hi = std::min(lo + 2 * width, parts.parts());
+            if (mid >= hi) return;
+            std::inplace_merge(v.begin() + parts.begin(lo), v.begin() + parts.begin(mid),
+                               v.begin() + parts.end(hi - 1), comp);
+        });
+    }
+}
+
+// ========== NUMA First-Touch Initialization ========== //
+/**
+ * CPUs grouped by NUMA node, read from /sys/devices/system/node on Linux.
+ * On other platforms, or when sysfs is unavailable, reports one node holding
+ * every hardware thread, so all callers keep working on single-node machines.
+ */
+struct NumaTopology {
+    std::vector<std::vector<int>> nodeCpus;  // CPU ids per node
+
+    std::size_t nodes() const noexcept { return nodeCpus.size(); }
+
+    static NumaTopology detect() {
+        NumaTopology topo;
+#if defined(__linux__)
+        for (int node : parseCpuList(readLine("/sys/devices/system/node/online"))) {
+            auto cpus = parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+            if (!cpus.empty()) topo.nodeCpus.push_back(std::move(cpus));
+        }
+#endif
+        if (topo.nodeCpus.empty()) {
+            const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+            topo.nodeCpus.emplace_back();
+            for (unsigned cpu = 0; cpu < hw; ++cpu) topo.nodeCpus[0].push_back(static_cast<int>(cpu));
+        }
+        return topo;
+    }
+
+    /**
+     * Parses the kernel list format, e.g. "0-3,8,10-11".
+     */
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> ids;
+        std::size_t pos = 0;
+        while (pos < list.size()) {
+            std::size_t comma = list.find(',', pos);
+            if (comma == std::string::npos) comma = list.size();
+            const std::string range = list.substr(pos, comma - pos);
+            const std::size_t dash = range.find('-');
+            try {
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int id = first; id <= last; ++id) ids.push_back(id);
+            } catch (const std::exception&) {
+                // Empty or malformed entry: skip it
+            }
+            pos = comma + 1;
+        }
+        return ids;
+    }
+
+private:
+    static std::string readLine(const std::string& path) {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    }
+};
+
+/**
+ * Pins the pool's workers across NUMA nodes in contiguous blocks: with W workers
+ * and N nodes, worker w runs on the CPUs of node w * N / W. Block placement keeps
+ * adjacent partitions (static schedule) on the same node.
+ *
+ * @return false if affinity is unsupported or any worker could not be pinned
+ *         (the pool keeps working unpinned)
+ */
+inline bool pinWorkersAcrossNodes(ForkJoinPool& pool, const NumaTopology& topo = NumaTopology::detect()) {
+#if defined(__linux__)
+    std::atomic<bool> ok{true};
+    const std::size_t workers = pool.size();
+    pool.forEachWorker([&](std::size_t w) {
+        const auto& cpus = topo.nodeCpus[w * topo.nodes() / workers];
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            ok.store(false, std::memory_order_relaxed);
+        }
+    });
+    return ok.load();
+#else
+    (void)pool;
+    (void)topo;
+    return false;
+#endif
+}
+
+/**
+ * Constructs count objects in raw aligned storage, each page-granular partition on
+ * the worker that owns it under the static schedule. Value-initialization of
+ * trivial types becomes a per-chunk memset. Construction must not throw.
+ *
+ * @tparam Alignment Alignment of `data` (selects partition boundaries)
+ */
+template<std::size_t Alignment = MEMORY_PAGE_SIZE, typename T, typename... Args>
+void parallelConstruct(ForkJoinPool& pool, T* data, std::size_t count, const Args&... args) {
+    static_assert(std::is_nothrow_constructible_v<T, const Args&...>,
+                  "parallelConstruct runs on worker threads and cannot propagate exceptions");
+    const AlignedPartitioner<T, Alignment> parts(count, pool.size(), PartitionGranularity::Page, data);
+    pool.forEachWorker([&](std::size_t w) {
+        const std::size_t b = parts.begin(w);
+        const std::size_t e = parts.end(w);
+        if constexpr (sizeof...(Args) == 0 && std::is_trivial_v<T>) {
+            if (e > b) std::memset(static_cast<void*>(data + b), 0, (e - b) * sizeof(T));
+        } else {
+            for (std::size_t i = b; i < e; ++i) new (&data[i]) T(args...);
+        }
+    });
+}
+
+/**
+ * Fixed-size aligned array whose pages are first touched, and elements constructed,
+ * by the pool workers that will later process them.
+ *
+ * An AlignedVector value-initialized on the main thread places every page on the
+ * main thread's node. FirstTouchArray allocates through AlignedAllocator without
+ * touching the memory, then constructs each page-granular partition on worker i.
+ * Run the parallel* algorithms on the same pool with PartitionGranularity::Page
+ * and each worker finds its partition in local memory.
+ *
+ * On a single-node machine this behaves like an ordinary aligned array.
+ *
+ * Usage:
+ *   ForkJoinPool pool;
+ *   pinWorkersAcrossNodes(pool);
+ *   FirstTouchArray<double> prices(pool, 1 << 24);      // Zeroed in parallel
+ *   parallelForEach(pool, prices, f, PartitionGranularity::Page);
+ *
+ * @tparam T Element type (nothrow constructible)
+ * @tparam Alignment Buffer alignment (defaults to page size)
+ */
+template<typename T, std::size_t Alignment = MEMORY_PAGE_SIZE>
+class FirstTouchArray {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    /**
+     * Allocates `count` elements and value-initializes them in parallel.
+     */
+    FirstTouchArray(ForkJoinPool& pool, std::size_t count)
+        : data_(AlignedAllocator<T, Alignment>().allocate(count)), size_(count) {
+        parallelConstruct<Alignment>(pool, data_, size_);
+    }
+
+    /**
+     * Allocates `count` elements and copy-constructs each from `value` in parallel.
+     */
+    FirstTouchArray(ForkJoinPool& pool, std::size_t count, const T& value)
+        : data_(AlignedAllocator<T, Alignment>().allocate(count)), size_(count) {
+        parallelConstruct<Alignment>(pool, data_, size_, value);
+    }
+
+    FirstTouchArray(const FirstTouchArray&) = delete;
+    FirstTouchArray& operator=(const FirstTouchArray&) = delete;
+
+    FirstTouchArray(FirstTouchArray&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    FirstTouchArray& operator=(FirstTouchArray&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~FirstTouchArray() { release(); }
+
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    T& operator[](std::size_t i) noexcept { return data_[i]; }
+    const T& operator[](std::size_t i) const noexcept { return data_[i]; }
+
+    iterator begin() noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+
+private:
+    void release() noexcept {
+        if (!data_) return;
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::size_t i = 0; i < size_; ++i) data_[i].~T();
+        }
+        AlignedAllocator<T, Alignment>().deallocate(data_, size_);
+        data_ = nullptr;
+    }
+
+    T* data_;
+    std::size_t size_;
+};
+
+template<typename T, std::size_t Alignment>
+struct ContainerAlignment<FirstTouchArray<T, Alignment>> {
+    static constexpr std::size_t value = Alignment;
+};
+
+// ========== Pooled Slab Backend ========== //
+/**
+ * Size classes of the slab engine: 16-byte steps up to 128, then four classes per
+ * power of two up to half a slab (32 KiB).
+ */
+struct SlabSizeClasses {
+    static constexpr std::size_t kCount = 40;
+    static constexpr std::size_t kMaxSize = 32768;
+
+    static constexpr std::array<std::uint32_t, kCount> sizes = [] {
+        std::array<std::uint32_t, kCount> table{};
+        std::size_t i = 0;
+        for (std::uint32_t s = 16; s <= 128; s += 16) table[i++] = s;
+        for (std::uint32_t base = 128; base < kMaxSize; base *= 2) {
+            for (std::uint32_t step = 1; step <= 4; ++step) table[i++] = base + step * (base / 4);
+        }
+        return table;
+    }();
+
+    static constexpr std::size_t kNone = kCount;
+};
+
+/**
+ * Compile-time size-class table for one `Alignment`.
+ *
+ * Only engine classes whose size is a multiple of the alignment are usable (blocks
+ * start on a slab boundary, so that keeps every block aligned): a 64-aligned
+ * allocator never sees 16- or 48-byte classes, and a 4096-aligned one only sees
+ * page multiples. `bySlot` maps every request size, in Alignment steps, straight
+ * to its class, so runtime lookup is one bounds check plus one table load and
+ * classFor() folds to a constant for fixed-size node types.
+ */
+template<std::size_t Alignment>
+struct AlignedSizeClasses {
+    static constexpr std::size_t kAlign = Alignment < 16 ? 16 : Alignment;
+    static constexpr std::size_t kSlots = (SlabSizeClasses::kMaxSize + kAlign - 1) / kAlign + 1;
+
+    // Engine class serving sizes in ((slot - 1) * kAlign, slot * kAlign]
+    static constexpr std::array<std::uint8_t, kSlots> bySlot = [] {
+        std::array<std::uint8_t, kSlots> table{};
+        for (std::size_t slot = 0; slot < kSlots; ++slot) {
+            const std::size_t bytes = slot == 0 ? 1 : slot * kAlign;
+            std::size_t cls = SlabSizeClasses::kNone;
+            for (std::size_t i = 0; i < SlabSizeClasses::kCount; ++i) {
+                if (SlabSizeClasses::sizes[i] >= bytes && SlabSizeClasses::sizes[i] % kAlign == 0) {
+                    cls = i;
+                    break;
+                }
+            }
+            table[slot] = static_cast<std::uint8_t>(cls);
+        }
+        return table;
+    }();
+
+    /**
+     * Engine class for `bytes`, or SlabSizeClasses::kNone if it bypasses the pool.
+     */
+    static constexpr std::size_t lookup(std::size_t bytes) noexcept {
+        return bytes <= SlabSizeClasses::kMaxSize ? bySlot[(bytes + kAlign - 1) / kAlign] : SlabSizeClasses::kNone;
+    }
+
+    /**
+     * Compile-time lookup, e.g. AlignedSizeClasses<64>::classFor(sizeof(Node)).
+     */
+    static consteval std::size_t classFor(std::size_t bytes) {
+        return lookup(bytes);
+    }
+};
+
+/**
+ * Runtime lookup for an alignment only known at run time (raw backend calls,
+ * trace replay). Dispatches once to the matching compile-time table.
+ */
+inline std::size_t slabClassFor(std::size_t bytes, std::size_t alignment) noexcept {
+    switch (alignment) {
+        case 1: case 2: case 4: case 8:
+        case 16:    return AlignedSizeClasses<16>::lookup(bytes);
+        case 32:    return AlignedSizeClasses<32>::lookup(bytes);
+        case 64:    return AlignedSizeClasses<64>::lookup(bytes);
+        case 128:   return AlignedSizeClasses<128>::lookup(bytes);
+        case 256:   return AlignedSizeClasses<256>::lookup(bytes);
+        case 512:   return AlignedSizeClasses<512>::lookup(bytes);
+        case 1024:  return AlignedSizeClasses<1024>::lookup(bytes);
+        case 2048:  return AlignedSizeClasses<2048>::lookup(bytes);
+        case 4096:  return AlignedSizeClasses<4096>::lookup(bytes);
+        case 8192:  return AlignedSizeClasses<8192>::lookup(bytes);
+        case 16384: return AlignedSizeClasses<16384>::lookup(bytes);
+        case 32768: return AlignedSizeClasses<32768>::lookup(bytes);
+        default:    return SlabSizeClasses::kNone;
+    }
+}
+
+/**
+ * Occupancy of one size class at the moment PooledAlignedBackend::stats() ran.
+ */
+struct SizeClassStats {
+    std::size_t blockSize = 0;
+    std::size_t slabs = 0;
+    std::size_t fullSlabs = 0;
+    std::size_t partialSlabs = 0;       // Some blocks live, some free
+    std::size_t emptySlabs = 0;         // Cached with no live block
+    std::size_t liveObjects = 0;
+    std::size_t freeObjects = 0;        // Unused capacity across this class's slabs
+    std::size_t requestedBytes = 0;     // Sum of sizes asked for by live allocations
+};
+
+/**
+ * Pool-wide utilization report.
+ *
+ * externalFragmentation: free block bytes stranded in slabs that also hold live
+ * blocks (cannot be returned to the OS), divided by all slab bytes.
+ * internalFragmentation: 1 - requested bytes / live block bytes (size-class rounding).
+ */
+struct PoolStats {
+    std::vector<SizeClassStats> classes;  // Only classes that own slabs
+    std::size_t slabBytes = 0;
+    std::size_t liveBlockBytes = 0;
+    std::size_t requestedBytes = 0;
+    std::size_t strandedFreeBytes = 0;
+    double externalFragmentation = 0.0;
+    double internalFragmentation = 0.0;
+};
+
+/**
+ * Slab allocator engine behind PooledAlignedBackend.
+ *
+ * Slabs are kSlabSize-aligned chunks of one reserved virtual range, so ownership
+ * of any pointer is a range check and its slab is found by shifting the offset.
+ * Slab headers live out of band in a parallel array; blocks therefore start at the
+ * slab boundary and a class whose size is a multiple of A yields A-aligned blocks.
+ *
+ * Each size class has its own SpinLock, a list of slabs with free space and keeps
+ * at most one empty slab cached; further empty slabs go back to the arena with
+ * their pages released to the OS.
+ */
+class SlabEngine {
+public:
+    static constexpr std::size_t kSlabSize = std::size_t{1} << 16;
+
+#if defined(ALIGNED_POOL_ARENA_BYTES)
+    static constexpr std::size_t kArenaBytes = ALIGNED_POOL_ARENA_BYTES;
+#else
+    static constexpr std::size_t kArenaBytes = std::size_t{1} << 34;  // 16 GiB of address space, committed lazily
+#endif
+
+    static SlabEngine& instance() noexcept {
+        static SlabEngine engine;
+        return engine;
+    }
+
+    /**
+     * True if `p` lies inside the slab arena.
+     */
+    bool owns(const void* p) const noexcept {
+        const auto addr = reinterpret_cast<std::uintptr_t>(p);
+        return addr - reinterpret_cast<std::uintptr_t>(base_) < reservedBytes_;
+    }
+
+    /**
+     * Allocates one block of size class `cls`.
+     * @return nullptr if the arena is exhausted or unavailable
+     */
+    void* allocate(std::size_t cls, std::size_t requested) noexcept {
+        ClassState& c = classes_[cls];
+        std::lock_guard<SpinLock> guard(c.lock);
+
+        Slab* slab = c.available;
+        if (!slab) {
+            slab = newSlab(static_cast<std::uint32_t>(cls));
+            if (!slab) return nullptr;
+            link(c.all, slab, &Slab::allPrev, &Slab::allNext);
+            link(c.available, slab, &Slab::availPrev, &Slab::availNext);
+            ++c.emptySlabs;
+        }
+
+        char* block;
+        if (slab->freeList) {
+            block = static_cast<char*>(slab->freeList);
+            slab->freeList = *reinterpret_cast<void**>(block);
+        } else {
+            block = slabBase(slab) + std::size_t{slab->bump++} * slab->blockSize;
+        }
+
+        if (slab->live++ == 0) --c.emptySlabs;
+        if (slab->live == slab->capacity) unlink(c.available, slab, &Slab::availPrev, &Slab::availNext);
+        c.requestedBytes += requested;
+        return block;
+    }
+
+    /**
+     * Returns a block obtained from allocate(); `p` must be owned by the engine.
+     */
+    void deallocate(void* p, std::size_t requested) noexcept {
+        Slab* slab = slabOf(p);
+        ClassState& c = classes_[slab->classIndex];
+        std::lock_guard<SpinLock> guard(c.lock);
+
+        *reinterpret_cast<void**>(p) = slab->freeList;
+        slab->freeList = p;
+        if (slab->live-- == slab->capacity) link(c.available, slab, &Slab::availPrev, &Slab::availNext);
+        c.requestedBytes -= requested;
+
+        if (slab->live == 0) {
+            if (c.emptySlabs == 0) {
+                ++c.emptySlabs;  // Keep one empty slab to avoid alloc/free ping-pong at the boundary
+            } else {
+                unlink(c.available, slab, &Slab::availPrev, &Slab::availNext);
+                unlink(c.all, slab, &Slab::allPrev, &Slab::allNext);
+                releaseSlab(slab);
+            }
+        }
+    }
+
+    /**
+     * Block size of the class serving `p`.
+     */
+    std::size_t blockSize(const void* p) const noexcept {
+        return slabOf(p)->blockSize;
+    }
+
+    PoolStats stats() {
+        PoolStats out;
+        for (std::size_t cls = 0; cls < SlabSizeClasses::kCount; ++cls) {
+            ClassState& c = classes_[cls];
+            std::lock_guard<SpinLock> guard(c.lock);
+            if (!c.all) continue;
+
+            SizeClassStats s;
+            s.blockSize = SlabSizeClasses::sizes[cls];
+            s.requestedBytes = c.requestedBytes;
+            for (Slab* slab = c.all; slab; slab = slab->allNext) {
+                ++s.slabs;
+                s.liveObjects += slab->live;
+                s.freeObjects += slab->capacity - slab->live;
+                if (slab->live == 0) ++s.emptySlabs;
+                else if (slab->live == slab->capacity) ++s.fullSlabs;
+                else {
+                    ++s.partialSlabs;
+                    out.strandedFreeBytes += std::size_t{slab->capacity - slab->live} * slab->blockSize;
+                }
+            }
+            out.slabBytes += s.slabs * kSlabSize;
+            out.liveBlockBytes += s.liveObjects * s.blockSize;
+            out.requestedBytes += s.requestedBytes;
+            out.classes.push_back(s);
+        }
+        if (out.slabBytes) out.externalFragmentation = static_cast<double>(out.strandedFreeBytes) / out.slabBytes;
+        if (out.liveBlockBytes) out.internalFragmentation = 1.0 - static_cast<double>(out.requestedBytes) / out.liveBlockBytes;
+        return out;
+    }
+
+    /**
+     * Writes one line per slab: index, block size, live/capacity and a map with one
+     * character per block ('#' live, '.' free, ' ' never carved).
+     * @return false if the file cannot be written
+     */
+    bool dumpOccupancy(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) return false;
+        std::fprintf(file, "# slab block_size live capacity map\n");
+
+        std::string map;
+        for (std::size_t cls = 0; cls < SlabSizeClasses::kCount; ++cls) {
+            ClassState& c = classes_[cls];
+            std::lock_guard<SpinLock> guard(c.lock);
+            for (Slab* slab = c.all; slab; slab = slab->allNext) {
+                map.assign(slab->capacity, ' ');
+                std::fill(map.begin(), map.begin() + slab->bump, '#');
+                for (void* f = slab->freeList; f; f = *static_cast<void**>(f)) {
+                    map[static_cast<std::size_t>(static_cast<char*>(f) - slabBase(slab)) / slab->blockSize] = '.';
+                }
+                std::fprintf(file, "%zu %u %u %u %s\n", static_cast<std::size_t>(slab - headers_),
+                             slab->blockSize, slab->live, slab->capacity, map.c_str());
+            }
+        }
+        return std::fclose(file) == 0;
+    }
+
+private:
+    struct Slab {
+        Slab* allNext;
+        Slab* allPrev;
+        Slab* availNext;
+        Slab* availPrev;
+        void* freeList;
+        std::uint32_t classIndex;
+        std::uint32_t blockSize;
+        std::uint32_t capacity;
+        std::uint32_t live;
+        std::uint32_t bump;      // Blocks carved so far
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ClassState {
+        SpinLock lock;
+        Slab* all = nullptr;
+        Slab* available = nullptr;  // Slabs with at least one free block
+        std::size_t emptySlabs = 0;
+        std::size_t requestedBytes = 0;
+    };
+
+    SlabEngine() noexcept {
+        // Shrink the reservation until the OS accepts it (e.g. strict overcommit)
+        for (std::size_t bytes = kArenaBytes; bytes >= 16 * kSlabSize && !base_; bytes /= 2) {
+            void* arena = reserve(bytes + kSlabSize);
+            if (!arena) continue;
+            headers_ = static_cast<Slab*>(reserve((bytes / kSlabSize) * sizeof(Slab)));
+            if (!headers_) {
+                unreserve(arena, bytes + kSlabSize);  // Retry smaller without leaking this reservation
+                continue;
+            }
+            // Align the usable range to kSlabSize so slab lookup is a shift
+            base_ = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(arena) + kSlabSize - 1) & ~(kSlabSize - 1));
+            maxSlabs_ = bytes / kSlabSize;
+            reservedBytes_ = bytes;
+        }
+    }
+
+    static void* reserve(std::size_t bytes) noexcept {
+#if defined(_WIN32)
+        return VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+#else
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+#endif
+    }
+
+    static void unreserve(void* p, std::size_t bytes) noexcept {
+#if defined(_WIN32)
+        (void)bytes;
+        VirtualFree(p, 0, MEM_RELEASE);
+#else
+        munmap(p, bytes);
+#endif
+    }
+
+    static bool commit(void* p, std::size_t bytes) noexcept {
+#if defined(_WIN32)
+        return VirtualAlloc(p, bytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        (void)p; (void)bytes;  // Anonymous mappings commit on first touch
+        return true;
+#endif
+    }
+
+    static void decommit(void* p, std::size_t bytes) noexcept {
+#if defined(_WIN32)
+        VirtualFree(p, bytes, MEM_DECOMMIT);
+#else
+        madvise(p, bytes, MADV_DONTNEED);
+#endif
+    }
+
+    char* slabBase(const Slab* slab) const noexcept {
+        return base_ + static_cast<std::size_t>(slab - headers_) * kSlabSize;
+    }
+
+    Slab* slabOf(const void* p) const noexcept {
+        return &headers_[(static_cast<const char*>(p) - base_) / kSlabSize];
+    }
+
+    Slab* newSlab(std::uint32_t cls) noexcept {
+        Slab* slab = nullptr;
+        {
+            std::lock_guard<SpinLock> guard(arenaLock_);
+            if (freeSlabs_) {
+                slab = freeSlabs_;
+                freeSlabs_ = slab->allNext;
+            } else if (nextSlab_ < maxSlabs_) {
+                if (!commit(headers_ + nextSlab_, sizeof(Slab))) return nullptr;
+                slab = &headers_[nextSlab_++];
+            } else {
+                return nullptr;
+            }
+        }
+        if (!commit(slabBase(slab), kSlabSize)) return nullptr;
+
+        const std::uint32_t size = SlabSizeClasses::sizes[cls];
+        *slab = Slab{nullptr, nullptr, nullptr, nullptr, nullptr, cls, size,
+                     static_cast<std::uint32_t>(kSlabSize / size), 0, 0};
+        return slab;
+    }
+
+    void releaseSlab(Slab* slab) noexcept {
+        decommit(slabBase(slab), kSlabSize);
+        std::lock_guard<SpinLock> guard(arenaLock_);
+        slab->allNext = freeSlabs_;
+        freeSlabs_ = slab;
+    }
+
+    static void link(Slab*& head, Slab* slab, Slab* Slab::*prev, Slab* Slab::*next) noexcept {
+        slab->*prev = nullptr;
+        slab->*next = head;
+        if (head) head->*prev = slab;
+        head = slab;
+    }
+
+    static void unlink(Slab*& head, Slab* slab, Slab* Slab::*prev, Slab* Slab::*next) noexcept {
+        if (slab->*prev) (slab->*prev)->*next = slab->*next;
+        else head = slab->*next;
+        if (slab->*next) (slab->*next)->*prev = slab->*prev;
+        slab->*prev = slab->*next = nullptr;
+    }
+
+    char* base_ = nullptr;
+    Slab* headers_ = nullptr;
+    std::size_t reservedBytes_ = 0;
+    std::size_t maxSlabs_ = 0;
+
+    SpinLock arenaLock_;
+    std::size_t nextSlab_ = 0;
+    Slab* freeSlabs_ = nullptr;
+
+    ClassState classes_[SlabSizeClasses::kCount];
+};
+
+/**
+ * Backend serving small and medium requests from the slab engine and everything
+ * else (larger than 32 KiB, or if the arena is exhausted) from SystemAlignedBackend.
+ * Frees are routed by address, so both kinds can be released through it.
+ *
+ * Usage:
+ *   std::map<int, Order, std::less<int>, PooledAlignedAllocator<std::pair<const int, Order>>> book;
+ *   PoolStats s = PooledAlignedBackend::stats();
+ */
+struct PooledAlignedBackend {
+    static constexpr const char* name = "pooled";
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        const std::size_t cls = slabClassFor(bytes, alignment);
+        if (cls != SlabSizeClasses::kNone) {
+            if (void* p = SlabEngine::instance().allocate(cls, bytes)) return p;
+        }
+        return SystemAlignedBackend::allocate(bytes, alignment);
+    }
+
+    /**
+     * Single-object path used by AlignedAllocator for allocate(1): the size class is a
+     * compile-time constant of (Alignment, Bytes), so there is no lookup at all.
+     */
+    template<std::size_t Alignment, std::size_t Bytes>
+    static void* allocateFixed() {
+        constexpr std::size_t cls = AlignedSizeClasses<Alignment>::classFor(Bytes);
+        if constexpr (cls != SlabSizeClasses::kNone) {
+            if (void* p = SlabEngine::instance().allocate(cls, Bytes)) return p;
+        }
+        return SystemAlignedBackend::allocate(Bytes, Alignment);
+    }
+
+    template<std::size_t Alignment, std::size_t Bytes>
+    static void deallocateFixed(void* p) noexcept {
+        deallocate(p, Bytes, Alignment);
+    }
+
+    static void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+        if (!p) return;
+        SlabEngine& engine = SlabEngine::instance();
+        if (engine.owns(p)) {
+            engine.deallocate(p, bytes);
+        } else {
+            SystemAlignedBackend::deallocate(p, bytes, alignment);
+        }
+    }
+
+    /**
+     * Per-size-class slab counts, live/free objects and fragmentation ratios.
+     */
+    static PoolStats stats() { return SlabEngine::instance().stats(); }
+
+    /**
+     * Dumps a per-slab occupancy map for offline visualization.
+     */
+    static bool dumpOccupancy(const std::string& path) { return SlabEngine::instance().dumpOccupancy(path); }
+};
+
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using PooledAlignedAllocator = AlignedAllocator<T, Alignment, PooledAlignedBackend>;
+
+// ========== TLSF Backend ========== //
+/**
+ * Two-level segregated fit heap over one preallocated region: allocate and
+ * free are O(1) in the worst case, whatever the size pattern.
+ *
+ * Free blocks are binned by a first level (power of two) and a second level
+ * (kSecondLevels linear steps inside it). Two bitmaps record which bins are
+ * non-empty, so finding a block that fits is two find-first-set operations;
+ * every search rounds the request up to the next bin so the first block found
+ * is always large enough. Freed blocks merge with free physical neighbours
+ * immediately, which bounds fragmentation (good-fit, no deferred coalescing).
+ *
+ * Over-aligned requests reserve `alignment` of slack and split the unused
+ * leading part off as a free block - still constant work.
+ *
+ * Block layout: a 16-byte header (previous physical block, payload size with
+ * flag bits) precedes every payload; free payloads hold the bin links. A
+ * zero-size used sentinel terminates the region.
+ */
+class TlsfHeap {
+public:
+    static constexpr std::size_t kAlign = 16;  // Payload granularity and minimum alignment
+
+#if defined(ALIGNED_TLSF_HEAP_BYTES)
+    static constexpr std::size_t kHeapBytes = ALIGNED_TLSF_HEAP_BYTES;
+#else
+    static constexpr std::size_t kHeapBytes = std::size_t{64} << 20;  // Mapped and pre-faulted on first use
+#endif
+
+    /**
+     * Heap behind TlsfAlignedBackend: kHeapBytes mapped once and pre-faulted, so
+     * no allocation ever takes a page fault or a syscall.
+     */
+    static TlsfHeap& instance() noexcept {
+        static TlsfHeap heap(mapRegion(kHeapBytes), kHeapBytes);
+        return heap;
+    }
+
+    /**
+     * Manages a caller-provided region (not owned). A null region yields a heap
+     * whose allocations all fail.
+     */
+    TlsfHeap(void* region, std::size_t bytes) noexcept {
+        if (!region || bytes < 4 * kMinBlock) return;
+        const auto begin = alignUp(reinterpret_cast<std::uintptr_t>(region), kAlign);
+        const auto end = (reinterpret_cast<std::uintptr_t>(region) + bytes) & ~(kAlign - 1);
+        base_ = reinterpret_cast<char*>(begin);
+        bytes_ = end - begin;
+
+        // One free block spanning the region, then the used sentinel
+        Block* first = reinterpret_cast<Block*>(base_);
+        first->prevPhys = nullptr;
+        first->sizeAndFlags = (bytes_ - 2 * kHeader) | kFreeBit;  // Assigned whole: the region may hold garbage
+        Block* sentinel = first->next();
+        sentinel->prevPhys = first;
+        sentinel->sizeAndFlags = kPrevFreeBit;
+        insert(first);
+        freeBytes_ = first->size();
+    }
+
+    TlsfHeap(const TlsfHeap&) = delete;
+    TlsfHeap& operator=(const TlsfHeap&) = delete;
+
+    bool owns(const void* p) const noexcept {
+        return reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(base_) < bytes_;
+    }
+
+    /**
+     * @param alignment Power of two
+     * @return nullptr if no free block can satisfy the request
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment) noexcept {
+        if (bytes > kMaxRequest || alignment > kMaxRequest) return nullptr;
+        const std::size_t size = adjustSize(bytes);
+        const bool overAligned = alignment > kAlign;
+        // Slack for an aligned payload plus a leading remainder big enough to be a block
+        const std::size_t search = overAligned ? size + alignment + kHeader + kMinBlock : size;
+
+        std::lock_guard<SpinLock> guard(lock_);
+        Block* block = findFit(search);
+        if (!block) return nullptr;
+        remove(block);
+
+        if (overAligned) {
+            const std::uintptr_t payload = reinterpret_cast<std::uintptr_t>(block->payload());
+            std::uintptr_t aligned = alignUp(payload, alignment);
+            if (aligned != payload) {
+                // The leading gap must itself hold a header plus a minimum payload
+                while (aligned - payload < kHeader + kMinBlock) aligned += alignment;
+                block = splitLeading(block, aligned - payload - kHeader);
+            }
+        }
+        splitTrailing(block, size);
+        markUsed(block);
+        freeBytes_ -= block->size();
+        return block->payload();
+    }
+
+    void deallocate(void* p) noexcept {
+        if (!p) return;
+        assert(owns(p));
+        std::lock_guard<SpinLock> guard(lock_);
+        Block* block = Block::fromPayload(p);
+        freeBytes_ += block->size();
+        markFree(block);
+        block = mergePrev(block);
+        block = mergeNext(block);
+        insert(block);
+    }
+
+    /** Payload bytes currently free (excluding block headers). */
+    std::size_t freeBytes() const noexcept { return freeBytes_; }
+    std::size_t capacity() const noexcept { return bytes_; }
+
+private:
+    static constexpr unsigned kSecondLevelLog2 = 5;
+    static constexpr unsigned kSecondLevels = 1u << kSecondLevelLog2;
+    static constexpr unsigned kAlignLog2 = 4;
+    static constexpr unsigned kFirstLevelShift = kSecondLevelLog2 + kAlignLog2;  // Sizes below 512 bytes: linear bins
+    static constexpr std::size_t kSmallBlock = std::size_t{1} << kFirstLevelShift;
+    static constexpr unsigned kFirstLevelMax = 40;  // Up to 1 TiB regions
+    static constexpr unsigned kFirstLevels = kFirstLevelMax - kFirstLevelShift + 1;
+    static constexpr std::size_t kMaxRequest = std::size_t{1} << (kFirstLevelMax - 1);
+
+    static constexpr std::size_t kFreeBit = 1;
+    static constexpr std::size_t kPrevFreeBit = 2;
+
+    struct Block {
+        Block* prevPhys;            // Previous block in address order
+        std::size_t sizeAndFlags;   // Payload bytes | kFreeBit | kPrevFreeBit
+        Block* nextFree;            // Free blocks only: bin links in the payload
+        Block* prevFree;
+
+        std::size_t size() const noexcept { return sizeAndFlags & ~(kAlign - 1); }
+        void setSize(std::size_t size) noexcept { sizeAndFlags = size | (sizeAndFlags & (kAlign - 1)); }
+        bool isFree() const noexcept { return sizeAndFlags & kFreeBit; }
+        bool isPrevFree() const noexcept { return sizeAndFlags & kPrevFreeBit; }
+        void* payload() noexcept { return reinterpret_cast<char*>(this) + kHeader; }
+        Block* next() noexcept { return reinterpret_cast<Block*>(static_cast<char*>(payload()) + size()); }
+
+        static Block* fromPayload(void* p) noexcept {
+            return reinterpret_cast<Block*>(static_cast<char*>(p) - kHeader);
+        }
+    };
+
+    static constexpr std::size_t kHeader = offsetof(Block, nextFree);
+    static constexpr std::size_t kMinBlock = sizeof(Block) - kHeader;  // Payload must hold the bin links
+    static_assert(kHeader == kAlign);
+
+    static std::uintptr_t alignUp(std::uintptr_t v, std::size_t a) noexcept { return (v + a - 1) & ~(a - 1); }
+
+    static std::size_t adjustSize(std::size_t bytes) noexcept {
+        return std::max(kMinBlock, static_cast<std::size_t>(alignUp(bytes, kAlign)));
+    }
+
+    static void mapping(std::size_t size, unsigned& fl, unsigned& sl) noexcept {
+        if (size < kSmallBlock) {
+            fl = 0;
+            sl = static_cast<unsigned>(size / (kSmallBlock / kSecondLevels));
+        } else {
+            const unsigned log2 = static_cast<unsigned>(std::bit_width(size)) - 1;
+            sl = static_cast<unsigned>(size >> (log2 - kSecondLevelLog2)) ^ kSecondLevels;
+            fl = log2 - kFirstLevelShift + 1;
+        }
+    }
+
+    // Rounds up to the next bin boundary, so any block in the bin found is big enough
+    static void mappingSearch(std::size_t size, unsigned& fl, unsigned& sl) noexcept {
+        if (size >= kSmallBlock) {
+            const unsigned log2 = static_cast<unsigned>(std::bit_width(size)) - 1;
+            size += (std::size_t{1} << (log2 - kSecondLevelLog2)) - 1;
+        }
+        mapping(size, fl, sl);
+    }
+
+    Block* findFit(std::size_t size) noexcept {
+        unsigned fl, sl;
+        mappingSearch(size, fl, sl);
+        if (fl >= kFirstLevels) return nullptr;
+        std::uint32_t slMap = secondLevelMap_[fl] & (~std::uint32_t{0} << sl);
+        if (!slMap) {
+            const std::uint64_t flMap = firstLevelMap_ & (~std::uint64_t{0} << (fl + 1));
+            if (!flMap) return nullptr;
+            fl = static_cast<unsigned>(std::countr_zero(flMap));
+            slMap = secondLevelMap_[fl];
+        }
+        sl = static_cast<unsigned>(std::countr_zero(slMap));
+        return bins_[fl][sl];
+    }
+
+    void insert(Block* block) noexcept {
+        unsigned fl, sl;
+        mapping(block->size(), fl, sl);
+        Block* head = bins_[fl][sl];
+        block->nextFree = head;
+        block->prevFree = nullptr;
+        if (head) head->prevFree = block;
+        bins_[fl][sl] = block;
+        firstLevelMap_ |= std::uint64_t{1} << fl;
+        secondLevelMap_[fl] |= std::uint32_t{1} << sl;
+    }
+
+    void remove(Block* block) noexcept {
+        unsigned fl, sl;
+        mapping(block->size(), fl, sl);
+        if (block->prevFree) block->prevFree->nextFree = block->nextFree;
+        else bins_[fl][sl] = block->nextFree;
+        if (block->nextFree) block->nextFree->prevFree = block->prevFree;
+        if (!bins_[fl][sl]) {
+            secondLevelMap_[fl] &= ~(std::uint32_t{1} << sl);
+            if (!secondLevelMap_[fl]) firstLevelMap_ &= ~(std::uint64_t{1} << fl);
+        }
+    }
+
+    void markUsed(Block* block) noexcept {
+        block->sizeAndFlags &= ~kFreeBit;
+        block->next()->sizeAndFlags &= ~kPrevFreeBit;
+    }
+
+    void markFree(Block* block) noexcept {
+        block->sizeAndFlags |= kFreeBit;
+        block->next()->sizeAndFlags |= kPrevFreeBit;
+    }
+
+    // Frees the first `leading` payload bytes of a (removed) free block as their own block
+    Block* splitLeading(Block* block, std::size_t leading) noexcept {
+        const std::size_t total = block->size();
+        block->setSize(leading);
+        Block* rest = block->next();
+        rest->prevPhys = block;
+        rest->sizeAndFlags = (total - leading - kHeader) | kPrevFreeBit;  // Not free: about to be used
+        rest->next()->prevPhys = rest;
+        block->sizeAndFlags |= kFreeBit;
+        insert(block);
+        freeBytes_ -= kHeader;
+        return rest;
+    }
+
+    // Returns whatever exceeds `size` (if it can form a block) to the bins
+    void splitTrailing(Block* block, std::size_t size) noexcept {
+        const std::size_t total = block->size();
+        if (total < size + kHeader + kMinBlock) return;
+        block->setSize(size);
+        Block* rest = block->next();
+        rest->prevPhys = block;
+        rest->sizeAndFlags = (total - size - kHeader) | kFreeBit;  // Previous (block) is about to be used
+        rest->next()->prevPhys = rest;
+        rest->next()->sizeAndFlags |= kPrevFreeBit;
+        insert(rest);
+        freeBytes_ -= kHeader;
+    }
+
+    Block* mergePrev(Block* block) noexcept {
+        if (!block->isPrevFree()) return block;
+        Block* prev = block->prevPhys;
+        remove(prev);
+        prev->setSize(prev->size() + kHeader + block->size());
+        prev->next()->prevPhys = prev;
+        freeBytes_ += kHeader;
+        return prev;
+    }
+
+    Block* mergeNext(Block* block) noexcept {
+        Block* next = block->next();
+        if (!next->isFree()) return block;
+        remove(next);
+        block->setSize(block->size() + kHeader + next->size());
+        block->next()->prevPhys = block;
+        freeBytes_ += kHeader;
+        return block;
+    }
+
+    static void* mapRegion(std::size_t bytes) noexcept {
+#if defined(_WIN32)
+        void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #if defined(MAP_POPULATE)
+        flags |= MAP_POPULATE;
+    #endif
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p == MAP_FAILED) return nullptr;
+#endif
+        // Touch every page so the first allocations never fault
+        if (p) {
+            for (std::size_t page = 0; page < bytes; page += MEMORY_PAGE_SIZE) static_cast<volatile char*>(p)[page] = 0;
+        }
+        return p;
+    }
+
+    SpinLock lock_;
+    char* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::size_t freeBytes_ = 0;
+    std::uint64_t firstLevelMap_ = 0;
+    std::array<std::uint32_t, kFirstLevels> secondLevelMap_{};
+    std::array<std::array<Block*, kSecondLevels>, kFirstLevels> bins_{};
+};
+
+/**
+ * Backend over TlsfHeap::instance(): bounded-time allocate/free for real-time
+ * threads. Never falls back to the system allocator - that would void the
+ * bound - so exhaustion of the heap throws std::bad_alloc.
+ */
+struct TlsfAlignedBackend {
+    static constexpr const char* name = "tlsf";
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        void* p = TlsfHeap::instance().allocate(bytes, alignment);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    static void deallocate(void* p, std::size_t, std::size_t) noexcept { TlsfHeap::instance().deallocate(p); }
+};
+
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+using TlsfAlignedAllocator = AlignedAllocator<T, Alignment, TlsfAlignedBackend>;
+
+// ========== LD_PRELOAD Shim ========== //
+/**
+ * Whole-process interposition of the C aligned-allocation entry points and the
+ * aligned operator new/delete family, backed by the SlabEngine. Lets third-party
+ * code that calls posix_memalign/aligned_alloc directly use the pooled engine.
+ *
+ * Build and use (glibc only):
+ *   g++ -std=c++20 -O2 -shared -fPIC -DALIGNED_ALLOCATOR_PRELOAD AlignedAllocator.cpp -o libaligned_preload.so -ldl
+ *   LD_PRELOAD=./libaligned_preload.so ./your_program
+ *
+ * Requests the engine cannot serve (over 32 KiB, over-aligned, arena exhausted)
+ * go to glibc's own memalign. free(), realloc() and malloc_usable_size() are
+ * interposed as well and route by address: pool blocks return to the engine,
+ * everything else to glibc. Plain malloc/calloc/new are not touched.
+ */
+#if defined(ALIGNED_ALLOCATOR_PRELOAD)
+#if !defined(__GLIBC__)
+    #error "ALIGNED_ALLOCATOR_PRELOAD relies on glibc's __libc_* entry points"
+#endif
+#include <cerrno>
+#include <dlfcn.h>
+#include <malloc.h>
+
+extern "C" {
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void* __libc_realloc(void* p, std::size_t size);
+void __libc_free(void* p);
+}
+
+namespace preload {
+
+inline bool isPowerOfTwo(std::size_t v) noexcept { return v && !(v & (v - 1)); }
+
+/**
+ * glibc's malloc_usable_size, for blocks the pool does not own. Its chunk
+ * overhead differs between heap and mmapped chunks, so it is not recomputed here.
+ */
+inline std::size_t libcUsableSize(void* p) noexcept {
+    using UsableSizeFn = std::size_t (*)(void*);
+    static const auto next = reinterpret_cast<UsableSizeFn>(dlsym(RTLD_NEXT, "malloc_usable_size"));
+    return next ? next(p) : 0;
+}
+
+/**
+ * Pool first, glibc memalign otherwise. Block-size accounting is used for
+ * requested bytes because free() cannot report the original size.
+ */
+inline void* alignedAllocate(std::size_t alignment, std::size_t size) noexcept {
+    const std::size_t cls = slabClassFor(size, alignment);
+    if (cls != SlabSizeClasses::kNone) {
+        if (void* p = SlabEngine::instance().allocate(cls, SlabSizeClasses::sizes[cls])) return p;
+    }
+    return __libc_memalign(alignment, size);
+}
+
+inline void release(void* p) noexcept {
+    if (!p) return;
+    SlabEngine& engine = SlabEngine::instance();
+    if (engine.owns(p)) {
+        engine.deallocate(p, engine.blockSize(p));
+    } else {
+        __libc_free(p);
+    }
+}
+
+inline void* alignedNew(std::size_t size, std::align_val_t al) {
+    void* p = alignedAllocate(static_cast<std::size_t>(al), size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+}  // namespace preload
+
+extern "C" {
+
+int posix_memalign(void** out, std::size_t alignment, std::size_t size) noexcept {
+    if (!preload::isPowerOfTwo(alignment) || alignment % sizeof(void*) != 0) return EINVAL;
+    void* p = preload::alignedAllocate(alignment, size);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+    if (!preload::isPowerOfTwo(alignment)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    void* p = preload::alignedAllocate(alignment, size);
+    if (!p) errno = ENOMEM;
+    return p;
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept {
+    // Like glibc: small alignments become the malloc default, others round up to a power of two
+    if (alignment < alignof(std::max_align_t)) alignment = alignof(std::max_align_t);
+    if (!preload::isPowerOfTwo(alignment)) {
+        if (alignment > (std::numeric_limits<std::size_t>::max() >> 1) + 1) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        alignment = std::bit_ceil(alignment);
+    }
+    return aligned_alloc(alignment, size);
+}
+
+void* valloc(std::size_t size) noexcept {
+    return aligned_alloc(MEMORY_PAGE_SIZE, size);
+}
+
+void* pvalloc(std::size_t size) noexcept {
+    return aligned_alloc(MEMORY_PAGE_SIZE, (size + MEMORY_PAGE_SIZE - 1) & ~(MEMORY_PAGE_SIZE - 1));
+}
+
+void free(void* p) noexcept {
+    preload::release(p);
+}
+
+void* realloc(void* p, std::size_t size) noexcept {
+    SlabEngine& engine = SlabEngine::instance();
+    if (!p || !engine.owns(p)) return __libc_realloc(p, size);
+
+    // Pool block: move it to glibc (realloc does not promise to keep over-alignment)
+    if (size == 0) {
+        preload::release(p);
+        return nullptr;
+    }
+    void* moved = __libc_realloc(nullptr, size);
+    if (!moved) return nullptr;
+    std::memcpy(moved, p, std::min(size, engine.blockSize(p)));
+    preload::release(p);
+    return moved;
+}
+
+std::size_t malloc_usable_size(void* p) noexcept {
+    if (!p) return 0;
+    SlabEngine& engine = SlabEngine::instance();
+    if (engine.owns(p)) return engine.blockSize(p);
+    return preload::libcUsableSize(p);
+}
+
+}  // extern "C"
+
+// Aligned operator new/delete (C++17)
+void* operator new(std::size_t size, std::align_val_t al) { return preload::alignedNew(size, al); }
+void* operator new[](std::size_t size, std::align_val_t al) { return preload::alignedNew(size, al); }
+
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return preload::alignedAllocate(static_cast<std::size_t>(al), size ? size : 1);
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return preload::alignedAllocate(static_cast<std::size_t>(al), size ? size : 1);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { preload::release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { preload::release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { preload::release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { preload::release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { preload::release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { preload::release(p); }
+#endif
+
+// ========== Allocation Trace Replay ========== //
+/**
+ * Results of replaying one trace against one backend.
+ */
+struct ReplayReport {
+    const char* backend = "";
+    std::size_t operations = 0;
+    double seconds = 0.0;
+    double p50Ns = 0.0;
+    double p99Ns = 0.0;
+    double p999Ns = 0.0;
+    double maxNs = 0.0;
+    std::size_t peakLiveBytes = 0;      // Peak of requested, not yet freed bytes
+    std::size_t peakRssDeltaBytes = 0;  // Peak resident set growth during the replay
+    double fragmentation = 0.0;         // 1 - peakLiveBytes / peakRssDeltaBytes
+    std::size_t unmatchedFrees = 0;     // Frees whose allocation is not in the trace
+};
+
+/**
+ * Offline replay of AllocationTraceRecorder files against allocation backends.
+ *
+ * load() orders the records by timestamp and resolves pointer ids into dense slot
+ * indices up front, so the timed replay does no hashing. Events from all threads
+ * are replayed on the calling thread in timestamp order.
+ *
+ * Usage (built-in tool):  ./AlignedAllocator --replay orders.aatrace
+ */
+class AllocationTraceReplayer {
+    struct Op {
+        std::uint32_t slot;
+        std::uint16_t alignmentLog2;
+        std::uint8_t op;
+        std::uint64_t size;
+    };
+
+public:
+    /**
+     * Reads and preprocesses a trace file.
+     * @return false if the file is missing or not a trace
+     */
+    bool load(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+
+        TraceFileHeader header{};
+        const bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                           std::memcmp(header.magic, "AATRACE1", 8) == 0 &&
+                           header.recordSize == sizeof(TraceRecord);
+        std::vector<TraceRecord> records;
+        if (valid) {
+            TraceRecord r;
+            while (std::fread(&r, sizeof(r), 1, file) == 1) records.push_back(r);
+        }
+        std::fclose(file);
+        if (!valid) return false;
+
+        std::stable_sort(records.begin(), records.end(),
+                         [](const TraceRecord& a, const TraceRecord& b) { return a.timestampNs < b.timestampNs; });
+
+        ops_.clear();
+        unmatchedFrees_ = 0;
+        std::unordered_map<std::uint64_t, std::uint32_t> liveSlots;
+        std::uint32_t nextSlot = 0;
+        for (const TraceRecord& r : records) {
+            if (r.op == static_cast<std::uint8_t>(TraceOp::Allocate)) {
+                liveSlots[r.ptrId] = nextSlot;  // An unseen free of a reused address leaves the old slot live
+                ops_.push_back(Op{nextSlot++, r.alignmentLog2, r.op, r.size});
+            } else {
+                auto it = liveSlots.find(r.ptrId);
+                if (it == liveSlots.end()) {
+                    ++unmatchedFrees_;
+                    continue;
+                }
+                ops_.push_back(Op{it->second, r.alignmentLog2, r.op, r.size});
+                liveSlots.erase(it);
+            }
+        }
+        slotCount_ = nextSlot;
+        return true;
+    }
+
+    std::size_t operations() const noexcept { return ops_.size(); }
+
+    /**
+     * Replays the loaded trace against `Backend`, freeing anything left live at the end.
+     */
+    template<typename Backend>
+    ReplayReport replay() const {
+        std::vector<void*> slots(slotCount_, nullptr);
+        std::vector<double> latencies(ops_.size());
+
+        ReplayReport report;
+        report.backend = Backend::name;
+        report.operations = ops_.size();
+        report.unmatchedFrees = unmatchedFrees_;
+
+        const std::size_t rssBefore = residentBytes();
+        std::size_t peakRss = rssBefore;
+        std::size_t liveBytes = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < ops_.size(); ++i) {
+            const Op& op = ops_[i];
+            const std::size_t alignment = std::size_t{1} << op.alignmentLog2;
+            const auto t0 = std::chrono::steady_clock::now();
+            if (op.op == static_cast<std::uint8_t>(TraceOp::Allocate)) {
+                slots[op.slot] = Backend::allocate(op.size, alignment);
+                liveBytes += op.size;
+            } else {
+                Backend::deallocate(slots[op.slot], op.size, alignment);
+                slots[op.slot] = nullptr;
+                liveBytes -= op.size;
+            }
+            latencies[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+            report.peakLiveBytes = std::max(report.peakLiveBytes, liveBytes);
+            if ((i & 1023) == 0) peakRss = std::max(peakRss, residentBytes());
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        peakRss = std::max(peakRss, residentBytes());
+
+        // Release leftovers; sizes are not needed by any backend for a live block of its own
+        for (std::size_t i = 0; i < ops_.size(); ++i) {
+            const Op& op = ops_[i];
+            if (op.op == static_cast<std::uint8_t>(TraceOp::Allocate) && slots[op.slot]) {
+                Backend::deallocate(slots[op.slot], op.size, std::size_t{1} << op.alignmentLog2);
+                slots[op.slot] = nullptr;
+            }
+        }
+
+        report.peakRssDeltaBytes = peakRss - rssBefore;
+        if (report.peakRssDeltaBytes > report.peakLiveBytes) {
+            report.fragmentation = 1.0 - static_cast<double>(report.peakLiveBytes) / report.peakRssDeltaBytes;
+        }
+
+        auto pct = [&](double p) {
+            if (latencies.empty()) return 0.0;
+            auto nth = latencies.begin() + static_cast<std::ptrdiff_t>(p * (latencies.size() - 1));
+            std::nth_element(latencies.begin(), nth, latencies.end());
+            return *nth;
+        };
+        report.p50Ns = pct(0.50);
+        report.p99Ns = pct(0.99);
+        report.p999Ns = pct(0.999);
+        report.maxNs = pct(1.0);
+        return report;
+    }
+
+    /**
+     * Current resident set size in bytes (0 where unsupported).
+     */
+    static std::size_t residentBytes() {
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        std::size_t totalPages = 0, residentPages = 0;
+        statm >> totalPages >> residentPages;
+        return residentPages * MEMORY_PAGE_SIZE;
+#else
+        return 0;
+#endif
+    }
+
+private:
+    std::vector<Op> ops_;
+    std::uint32_t slotCount_ = 0;
+    std::size_t unmatchedFrees_ = 0;
+};
+
+// Backends the replay tool compares; append new backends here
+using ReplayBackends = std::tuple<SystemAlignedBackend, NewAlignedBackend, PooledAlignedBackend, TlsfAlignedBackend>;
+
+/**
+ * Replays `path` against every backend in ReplayBackends and prints a table.
+ * @return false if the trace cannot be loaded
+ */
+inline bool replayAllocationTrace(const std::string& path) {
+    AllocationTraceReplayer replayer;
+    if (!replayer.load(path)) {
+        std::fprintf(stderr, "cannot read allocation trace '%s'\n", path.c_str());
+        return false;
+    }
+
+    std::printf("%-14s %10s %12s %8s %8s %9s %9s %12s %12s %7s\n", "backend", "ops", "ops/s",
+                "p50 ns", "p99 ns", "p99.9 ns", "max ns", "peak live", "peak RSS+", "frag");
+    std::apply([&](auto... backend) {
+        (([&] {
+            ReplayReport r;
+            try {
+                r = replayer.replay<decltype(backend)>();
+            } catch (const std::bad_alloc&) {  // Fixed-size heaps (tlsf) can run out on large traces
+                std::printf("%-14s out of memory\n", decltype(backend)::name);
+                return;
+            }
+            std::printf("%-14s %10zu %12.0f %8.0f %8.0f %9.0f %9.0f %12zu %12zu %6.1f%%\n", r.backend,
+                        r.operations, r.seconds > 0 ? r.operations / r.seconds : 0.0, r.p50Ns, r.p99Ns,
+                        r.p999Ns, r.maxNs, r.peakLiveBytes, r.peakRssDeltaBytes, r.fragmentation * 100.0);
+        }()), ...);
+    }, ReplayBackends{});
+    return true;
+}
+
+// ========== AlignedPriorityQueue ========== //
+/**
+ * Cache-line d-ary heap priority queue with stable handles.
+ *
+ * The arity is chosen so all children of a node fill exactly one cache line
+ * (d = CACHE_LINE_SIZE / sizeof(T), at least 2). Elements are stored shifted by
+ * d - 1 slots, which puts every sibling group on a line boundary of the aligned
+ * storage: sift-down costs one line per level instead of one miss per child, and
+ * the tree is log_d(n) deep rather than log_2(n).
+ *
+ * Like std::priority_queue, top() is the element for which Compare orders every
+ * other element before it (std::less gives a max-heap, std::greater a min-heap).
+ *
+ * push() returns a Handle that stays valid until the element is popped or erased;
+ * update(handle, value) implements decrease-key/increase-key.
+ *
+ * @tparam T Element type (best when sizeof(T) divides CACHE_LINE_SIZE)
+ * @tparam Compare Strict weak ordering
+ * @tparam Alignment Storage alignment
+ */
+template<typename T, typename Compare = std::less<T>, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedPriorityQueue {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using Handle = std::uint32_t;
+
+    static constexpr std::size_t kArity = CACHE_LINE_SIZE / sizeof(T) >= 2 ? CACHE_LINE_SIZE / sizeof(T) : 2;
+
+    explicit AlignedPriorityQueue(const Compare& comp = Compare{}) : comp_(comp) {
+        values_.resize(kOffset);
+        handleAt_.resize(kOffset);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    size_type size() const noexcept { return values_.size() - kOffset; }
+
+    void reserve(size_type n) {
+        values_.reserve(n + kOffset);
+        handleAt_.reserve(n + kOffset);
+    }
+
+    const T& top() const noexcept {
+        assert(!empty());
+        return values_[kOffset];
+    }
+
+    /**
+     * Handle of the current top element.
+     */
+    Handle topHandle() const noexcept { return handleAt_[kOffset]; }
+
+    Handle push(const T& value) {
+        const Handle h = appendRaw(value);
+        siftUp(values_.size() - 1);
+        return h;
+    }
+
+    /**
+     * Inserts a range. Large batches (relative to the current size) are appended
+     * and re-heapified bottom-up in O(n); small ones are sifted up individually.
+     * @param handles Optional output receiving one handle per inserted element
+     */
+    template<typename InputIt>
+    void pushBatch(InputIt first, InputIt last, std::vector<Handle>* handles = nullptr) {
+        const size_type before = size();
+        for (; first != last; ++first) {
+            const Handle h = appendRaw(*first);
+            if (handles) handles->push_back(h);
+        }
+        const size_type added = size() - before;
+        if (added > before) {
+            // Floyd: sift down every internal node, last parent first
+            for (size_type k = (size() + kArity - 2) / kArity; k-- > 0;) siftDown(k + kOffset);
+        } else {
+            for (size_type pos = before + kOffset; pos < values_.size(); ++pos) siftUp(pos);
+        }
+    }
+
+    void pop() {
+        assert(!empty());
+        removeAt(kOffset);
+    }
+
+    /**
+     * Replaces the value behind `h` and restores heap order (decrease- or increase-key).
+     */
+    void update(Handle h, const T& value) {
+        const size_type pos = positionOf_[h];
+        assert(pos != kInvalid);
+        values_[pos] = value;
+        siftDown(siftUp(pos));
+    }
+
+    /**
+     * Removes the element behind `h`.
+     */
+    void erase(Handle h) {
+        const size_type pos = positionOf_[h];
+        assert(pos != kInvalid);
+        removeAt(pos);
+    }
+
+    bool contains(Handle h) const noexcept {
+        return h < positionOf_.size() && positionOf_[h] != kInvalid;
+    }
+
+    const T& value(Handle h) const noexcept { return values_[positionOf_[h]]; }
+
+    void clear() noexcept {
+        for (size_type pos = kOffset; pos < values_.size(); ++pos) release(handleAt_[pos]);
+        values_.resize(kOffset);
+        handleAt_.resize(kOffset);
+    }
+
+private:
+    static constexpr size_type kOffset = kArity - 1;  // Line-aligns every sibling group
+    static constexpr size_type kInvalid = std::numeric_limits<size_type>::max();
+
+    // Heap index k lives at position k + kOffset; children of k are d*k+1 .. d*k+d
+    static size_type firstChild(size_type pos) noexcept { return (pos - kOffset) * kArity + 1 + kOffset; }
+    static size_type parent(size_type pos) noexcept { return (pos - kOffset - 1) / kArity + kOffset; }
+
+    Handle appendRaw(const T& value) {
+        Handle h;
+        if (!freeHandles_.empty()) {
+            h = freeHandles_.back();
+            freeHandles_.pop_back();
+        } else {
+            h = static_cast<Handle>(positionOf_.size());
+            positionOf_.push_back(kInvalid);
+        }
+        values_.push_back(value);
+        handleAt_.push_back(h);
+        positionOf_[h] = values_.size() - 1;
+        return h;
+    }
+
+    void release(Handle h) {
+        positionOf_[h] = kInvalid;
+        freeHandles_.push_back(h);
+    }
+
+    void removeAt(size_type pos) {
+        release(handleAt_[pos]);
+        const size_type last = values_.size() - 1;
+        if (pos != last) {
+            values_[pos] = std::move(values_[last]);
+            handleAt_[pos] = handleAt_[last];
+            positionOf_[handleAt_[pos]] = pos;
+        }
+        values_.pop_back();
+        handleAt_.pop_back();
+        if (pos < values_.size()) siftDown(siftUp(pos));
+    }
+
+    void place(size_type pos, T&& value, Handle h) noexcept {
+        values_[pos] = std::move(value);
+        handleAt_[pos] = h;
+        positionOf_[h] = pos;
+    }
+
+    size_type siftUp(size_type pos) {
+        T value = std::move(values_[pos]);
+        const Handle h = handleAt_[pos];
+        while (pos > kOffset) {
+            const size_type p = parent(pos);
+            if (!comp_(values_[p], value)) break;
+            place(pos, std::move(values_[p]), handleAt_[p]);
+            pos = p;
+        }
+        place(pos, std::move(value), h);
+        return pos;
+    }
+
+    size_type siftDown(size_type pos) {
+        const size_type end = values_.size();
+        T value = std::move(values_[pos]);
+        const Handle h = handleAt_[pos];
+        for (;;) {
+            const size_type first = firstChild(pos);
+            if (first >= end) break;
+            // Scan the sibling group (one cache line) for the highest-priority child
+            const size_type last = std::min(first + kArity, end);
+            size_type best = first;
+            for (size_type c = first + 1; c < last; ++c) {
+                if (comp_(values_[best], values_[c])) best = c;
+            }
+            if (!comp_(value, values_[best])) break;
+            place(pos, std::move(values_[best]), handleAt_[best]);
+            pos = best;
+        }
+        place(pos, std::move(value), h);
+        return pos;
+    }
+
+    AlignedVector<T, Alignment> values_;
+    AlignedVector<Handle, Alignment> handleAt_;     // Position -> handle
+    AlignedVector<size_type, Alignment> positionOf_;  // Handle -> position
+    std::vector<Handle> freeHandles_;
+    Compare comp_;
+};
+
+// ========== AlignedFlatMap ========== //
+/**
+ * Physical key order of an AlignedFlatMap.
+ * Sorted: plain sorted arrays; branchless binary search finished by a vectorizable scan.
+ * Eytzinger: BFS (heap) order; the search path is branch-free and the next levels
+ * are prefetched one cache line at a time, which wins once the keys outgrow the caches.
+ */
+enum class FlatMapLayout {
+    Sorted,
+    Eytzinger
+};
+
+/**
+ * Read-mostly map stored as structure-of-arrays in aligned storage: one array of
+ * keys (the only thing a lookup touches) and one of values in the same order.
+ *
+ * Built once from unsorted input, then only read. Lookups never allocate and walk
+ * contiguous, cache-line aligned key data instead of chasing tree nodes.
+ *
+ * Iteration is always in key order, whatever the layout. Duplicate keys in the
+ * build input keep their first occurrence (as std::map::insert would).
+ *
+ * @tparam Key Key type
+ * @tparam T Mapped type
+ * @tparam Layout Physical key order
+ * @tparam Compare Strict weak ordering on keys
+ * @tparam Alignment Alignment of the key and value arrays
+ */
+template<typename Key, typename T, FlatMapLayout Layout = FlatMapLayout::Sorted,
+         typename Compare = std::less<Key>, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedFlatMap {
+    // Eytzinger keys are 1-indexed; slot 0 is unused and `end` is slot 0
+    static constexpr std::size_t kBase = Layout == FlatMapLayout::Eytzinger ? 1 : 0;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = std::size_t;
+
+    struct reference {
+        const Key& first;
+        const T& second;
+    };
+
+    class const_iterator {
+    public:
+        reference operator*() const noexcept { return {map_->keys_[slot_], map_->values_[slot_]}; }
+        const Key& key() const noexcept { return map_->keys_[slot_]; }
+        const T& value() const noexcept { return map_->values_[slot_]; }
+
+        const_iterator& operator++() noexcept {
+            slot_ = map_->nextSlot(slot_);
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept { return slot_ == other.slot_; }
+        bool operator!=(const const_iterator& other) const noexcept { return slot_ != other.slot_; }
+
+    private:
+        friend class AlignedFlatMap;
+        const_iterator(const AlignedFlatMap* map, size_type slot) noexcept : map_(map), slot_(slot) {}
+
+        const AlignedFlatMap* map_;
+        size_type slot_;
+    };
+
+    AlignedFlatMap() = default;
+
+    /**
+     * Bulk build from an unsorted range of std::pair<Key, T>.
+     */
+    template<typename InputIt>
+    AlignedFlatMap(InputIt first, InputIt last, const Compare& comp = Compare{}) : comp_(comp) {
+        build(std::vector<std::pair<Key, T>>(first, last));
+    }
+
+    /**
+     * Replaces the contents with `items` (any order).
+     */
+    void build(std::vector<std::pair<Key, T>> items) {
+        std::stable_sort(items.begin(), items.end(),
+                         [&](const auto& a, const auto& b) { return comp_(a.first, b.first); });
+        items.erase(std::unique(items.begin(), items.end(),
+                                [&](const auto& a, const auto& b) { return !comp_(a.first, b.first); }),
+                    items.end());
+
+        size_ = items.size();
+        keys_.assign(size_ + kBase, Key{});
+        values_.assign(size_ + kBase, T{});
+
+        if constexpr (Layout == FlatMapLayout::Sorted) {
+            for (size_type i = 0; i < size_; ++i) {
+                keys_[i] = std::move(items[i].first);
+                values_[i] = std::move(items[i].second);
+            }
+        } else {
+            size_type next = 0;
+            fillEytzinger(items, 1, next);
+        }
+    }
+
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    const_iterator begin() const noexcept {
+        if constexpr (Layout == FlatMapLayout::Sorted) {
+            return {this, 0};
+        } else {
+            size_type k = size_ ? 1 : 0;
+            while (k && 2 * k <= size_) k *= 2;  // Leftmost node
+            return {this, k};
+        }
+    }
+
+    const_iterator end() const noexcept { return {this, Layout == FlatMapLayout::Sorted ? size_ : 0}; }
+
+    /**
+     * First element whose key is not ordered before `key`.
+     */
+    const_iterator lower_bound(const Key& key) const noexcept {
+        return {this, lowerBoundSlot(key)};
+    }
+
+    const_iterator find(const Key& key) const noexcept {
+        const size_type slot = lowerBoundSlot(key);
+        if (slot != end().slot_ && !comp_(key, keys_[slot])) return {this, slot};
+        return end();
+    }
+
+    bool contains(const Key& key) const noexcept { return find(key) != end(); }
+
+    /**
+     * @throws std::out_of_range if `key` is absent
+     */
+    const T& at(const Key& key) const {
+        const const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("AlignedFlatMap::at");
+        return it.value();
+    }
+
+private:
+    static constexpr size_type kLinearScan = CACHE_LINE_SIZE / sizeof(Key) > 4 ? CACHE_LINE_SIZE / sizeof(Key) : 4;
+
+    size_type lowerBoundSlot(const Key& key) const noexcept {
+        if constexpr (Layout == FlatMapLayout::Sorted) {
+            // Branchless halving (compiles to cmov) down to about one cache line
+            const Key* base = keys_.data();
+            size_type len = size_;
+            while (len > kLinearScan) {
+                const size_type half = len / 2;
+                base = comp_(base[half - 1], key) ? base + half : base;
+                len -= half;
+            }
+            // Fixed-shape counting loop: vectorized for arithmetic keys, no early exit
+            size_type count = 0;
+            for (size_type i = 0; i < len; ++i) count += comp_(base[i], key) ? 1 : 0;
+            return static_cast<size_type>(base - keys_.data()) + count;
+        } else {
+            const Key* keys = keys_.data();
+            size_type k = 1;
+            while (k <= size_) {
+#if defined(__GNUC__)
+                // The 16-way (4-byte keys) or 8-way descendants share one line
+                __builtin_prefetch(keys + std::min(k * kLinearScan, size_));
+#endif
+                k = 2 * k + (comp_(keys[k], key) ? 1 : 0);
+            }
+            // Undo the trailing right turns; 0 means every key is smaller
+            return k >> (std::countr_one(k) + 1);
+        }
+    }
+
+    size_type nextSlot(size_type k) const noexcept {
+        if constexpr (Layout == FlatMapLayout::Sorted) {
+            return k + 1;
+        } else {
+            if (2 * k + 1 <= size_) {
+                k = 2 * k + 1;
+                while (2 * k <= size_) k *= 2;
+                return k;
+            }
+            while (k & 1) k >>= 1;  // Climb while we are a right child
+            return k >> 1;
+        }
+    }
+
+    void fillEytzinger(std::vector<std::pair<Key, T>>& sorted, size_type k, size_type& next) {
+        if (k > size_) return;
+        fillEytzinger(sorted, 2 * k, next);
+        keys_[k] = std::move(sorted[next].first);
+        values_[k] = std::move(sorted[next].second);
+        ++next;
+        fillEytzinger(sorted, 2 * k + 1, next);
+    }
+
+    AlignedVector<Key, Alignment> keys_;
+    AlignedVector<T, Alignment> values_;
+    size_type size_ = 0;
+    Compare comp_{};
+};
+
+// ========== AlignedBitset ========== //
+// Runtime ISA dispatch needs GCC/Clang target attributes on x86
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define ALIGNED_BITSET_X86_DISPATCH 1
+#endif
+
+/**
+ * Word kernels behind AlignedBitset / AlignedDynamicBitset.
+ *
+ * Each kernel has a portable body plus AVX2 and AVX-512 bodies compiled with
+ * target attributes; the best set is picked once from the CPU feature bits, so
+ * the same binary runs on any x86-64. Word arrays start on a cache line (aligned
+ * vector loads); the word count may be anything, the tail is done in scalar.
+ */
+namespace bitkernels {
+
+using Word = std::uint64_t;
+
+enum class BitOp { And, Or, Xor, AndNot };
+
+template<BitOp Op>
+constexpr Word combine(Word a, Word b) noexcept {
+    if constexpr (Op == BitOp::And) return a & b;
+    else if constexpr (Op == BitOp::Or) return a | b;
+    else if constexpr (Op == BitOp::Xor) return a ^ b;
+    else return a & ~b;
+}
+
+template<BitOp Op>
+void applyPortable(Word* dst, const Word* src, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) dst[i] = combine<Op>(dst[i], src[i]);
+}
+
+inline std::size_t popcountPortable(const Word* words, std::size_t n) noexcept {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) count += std::popcount(words[i]);
+    return count;
+}
+
+#if defined(ALIGNED_BITSET_X86_DISPATCH)
+template<BitOp Op>
+__attribute__((target("avx2"))) void applyAvx2(Word* dst, const Word* src, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i r;
+        if constexpr (Op == BitOp::And) r = _mm256_and_si256(a, b);
+        else if constexpr (Op == BitOp::Or) r = _mm256_or_si256(a, b);
+        else if constexpr (Op == BitOp::Xor) r = _mm256_xor_si256(a, b);
+        else r = _mm256_andnot_si256(b, a);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), r);
+    }
+    for (; i < n; ++i) dst[i] = combine<Op>(dst[i], src[i]);
+}
+
+// Nibble lookup (pshufb) per byte, summed per 64-bit lane with psadbw
+__attribute__((target("avx2"))) inline std::size_t popcountAvx2(const Word* words, std::size_t n) noexcept {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(words + i));
+        const __m256i lo = _mm256_and_si256(v, lowNibble);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+        const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    std::size_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) count += std::popcount(words[i]);
+    return count;
+}
+
+template<BitOp Op>
+__attribute__((target("avx512f"))) void applyAvx512(Word* dst, const Word* src, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m512i a = _mm512_load_si512(dst + i);
+        const __m512i b = _mm512_load_si512(src + i);
+        __m512i r;
+        if constexpr (Op == BitOp::And) r = _mm512_and_si512(a, b);
+        else if constexpr (Op == BitOp::Or) r = _mm512_or_si512(a, b);
+        else if constexpr (Op == BitOp::Xor) r = _mm512_xor_si512(a, b);
+        else r = _mm512_and_si512(a, _mm512_xor_si512(b, _mm512_set1_epi64(-1)));  // Folded to vpandnq
+        _mm512_store_si512(dst + i, r);
+    }
+    for (; i < n; ++i) dst[i] = combine<Op>(dst[i], src[i]);
+}
+
+// Spelled out: GCC 12's _mm512_reduce_add_epi64 trips -Wuninitialized
+__attribute__((target("avx512f"))) inline std::size_t sumLanes(__m512i v) noexcept {
+    alignas(64) std::uint64_t lanes[8];
+    _mm512_store_si512(lanes, v);
+    std::size_t sum = 0;
+    for (const std::uint64_t lane : lanes) sum += lane;
+    return sum;
+}
+
+// Ice Lake and later: one vpopcntq per cache line
+__attribute__((target("avx512f,avx512vpopcntdq"))) inline std::size_t popcountAvx512(const Word* words,
+                                                                                     std::size_t n) noexcept {
+    __m512i total = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_load_si512(words + i)));
+    std::size_t count = sumLanes(total);
+    for (; i < n; ++i) count += std::popcount(words[i]);
+    return count;
+}
+
+// Skylake-X: AVX2 nibble lookup widened to 512 bits
+__attribute__((target("avx512f,avx512bw"))) inline std::size_t popcountAvx512Bw(const Word* words,
+                                                                                std::size_t n) noexcept {
+    const __m512i lut = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+    const __m512i lowNibble = _mm512_set1_epi8(0x0f);
+    __m512i total = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m512i v = _mm512_load_si512(words + i);
+        const __m512i lo = _mm512_and_si512(v, lowNibble);
+        const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), lowNibble);
+        const __m512i bytes = _mm512_add_epi8(_mm512_shuffle_epi8(lut, lo), _mm512_shuffle_epi8(lut, hi));
+        total = _mm512_add_epi64(total, _mm512_sad_epu8(bytes, _mm512_setzero_si512()));
+    }
+    std::size_t count = sumLanes(total);
+    for (; i < n; ++i) count += std::popcount(words[i]);
+    return count;
+}
+#endif
+
+struct Kernels {
+    using Apply = void (*)(Word*, const Word*, std::size_t) noexcept;
+    using Popcount = std::size_t (*)(const Word*, std::size_t) noexcept;
+
+    const char* name;
+    Apply apply[4];  // Indexed by BitOp
+    Popcount popcount;
+};
+
+/**
+ * Kernel set for this CPU, chosen on first use.
+ */
+inline const Kernels& kernels() noexcept {
+    static const Kernels selected = [] {
+#if defined(ALIGNED_BITSET_X86_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            const bool vpopcnt = __builtin_cpu_supports("avx512vpopcntdq");
+            return Kernels{vpopcnt ? "avx512-vpopcntdq" : "avx512",
+                           {&applyAvx512<BitOp::And>, &applyAvx512<BitOp::Or>,
+                            &applyAvx512<BitOp::Xor>, &applyAvx512<BitOp::AndNot>},
+                           vpopcnt ? &popcountAvx512 : &popcountAvx512Bw};
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return Kernels{"avx2",
+                           {&applyAvx2<BitOp::And>, &applyAvx2<BitOp::Or>,
+                            &applyAvx2<BitOp::Xor>, &applyAvx2<BitOp::AndNot>},
+                           &popcountAvx2};
+        }
+#endif
+        return Kernels{"portable",
+                       {&applyPortable<BitOp::And>, &applyPortable<BitOp::Or>,
+                        &applyPortable<BitOp::Xor>, &applyPortable<BitOp::AndNot>},
+                       &popcountPortable};
+    }();
+    return selected;
+}
+
+}  // namespace bitkernels
+
+/**
+ * Operations shared by the fixed and dynamic bitsets (CRTP).
+ *
+ * Derived provides data(), wordCount() and size(). Storage is a whole number of
+ * cache lines and every bit at or past size() is kept zero, so bulk operations
+ * and popcount run over full words without masking.
+ */
+template<typename Derived>
+class BitsetBase {
+public:
+    using Word = bitkernels::Word;
+    static constexpr std::size_t kWordBits = 64;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    bool test(std::size_t pos) const noexcept {
+        assert(pos < self().size());
+        return (self().data()[pos / kWordBits] >> (pos % kWordBits)) & 1;
+    }
+
+    bool operator[](std::size_t pos) const noexcept { return test(pos); }
+
+    Derived& set(std::size_t pos, bool value = true) noexcept {
+        assert(pos < self().size());
+        Word& word = self().data()[pos / kWordBits];
+        const Word mask = Word{1} << (pos % kWordBits);
+        word = value ? (word | mask) : (word & ~mask);
+        return self();
+    }
+
+    Derived& reset(std::size_t pos) noexcept { return set(pos, false); }
+
+    Derived& flip(std::size_t pos) noexcept {
+        assert(pos < self().size());
+        self().data()[pos / kWordBits] ^= Word{1} << (pos % kWordBits);
+        return self();
+    }
+
+    Derived& set() noexcept {
+        std::fill_n(self().data(), self().wordCount(), ~Word{0});
+        clearTail();
+        return self();
+    }
+
+    Derived& reset() noexcept {
+        std::fill_n(self().data(), self().wordCount(), Word{0});
+        return self();
+    }
+
+    Derived& flip() noexcept {
+        Word* words = self().data();
+        for (std::size_t i = 0; i < self().wordCount(); ++i) words[i] = ~words[i];
+        clearTail();
+        return self();
+    }
+
+    std::size_t count() const noexcept { return bitkernels::kernels().popcount(self().data(), self().wordCount()); }
+
+    bool any() const noexcept { return findFirst() != npos; }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == self().size(); }
+
+    /**
+     * Lowest set bit, or npos.
+     */
+    std::size_t findFirst() const noexcept { return findFrom(0); }
+
+    /**
+     * Lowest set bit strictly after `pos`, or npos.
+     */
+    std::size_t findNext(std::size_t pos) const noexcept { return findFrom(pos + 1); }
+
+    /**
+     * Calls fn(pos) for every set bit in increasing order.
+     */
+    template<typename F>
+    void forEachSet(F&& fn) const {
+        const Word* words = self().data();
+        for (std::size_t i = 0; i < self().wordCount(); ++i) {
+            for (Word w = words[i]; w; w &= w - 1) fn(i * kWordBits + std::countr_zero(w));
+        }
+    }
+
+    /**
+     * Number of set bits in [0, pos).
+     */
+    std::size_t rank(std::size_t pos) const noexcept {
+        assert(pos <= self().size());
+        const Word* words = self().data();
+        const std::size_t full = pos / kWordBits;
+        std::size_t count = bitkernels::kernels().popcount(words, full);
+        if (pos % kWordBits) count += std::popcount(words[full] & ((Word{1} << (pos % kWordBits)) - 1));
+        return count;
+    }
+
+    /**
+     * Position of the k-th set bit (0-based), or npos if fewer are set.
+     */
+    std::size_t select(std::size_t k) const noexcept {
+        const Word* words = self().data();
+        for (std::size_t i = 0; i < self().wordCount(); ++i) {
+            const std::size_t inWord = std::popcount(words[i]);
+            if (k < inWord) {
+                Word w = words[i];
+                for (std::size_t j = 0; j < k; ++j) w &= w - 1;
+                return i * kWordBits + std::countr_zero(w);
+            }
+            k -= inWord;
+        }
+        return npos;
+    }
+
+    Derived& operator&=(const Derived& other) noexcept { return apply(bitkernels::BitOp::And, other); }
+    Derived& operator|=(const Derived& other) noexcept { return apply(bitkernels::BitOp::Or, other); }
+    Derived& operator^=(const Derived& other) noexcept { return apply(bitkernels::BitOp::Xor, other); }
+
+    /**
+     * Clears every bit that is set in `other` (this & ~other).
+     */
+    Derived& andNot(const Derived& other) noexcept { return apply(bitkernels::BitOp::AndNot, other); }
+
+    friend Derived operator&(Derived a, const Derived& b) noexcept { return a &= b; }
+    friend Derived operator|(Derived a, const Derived& b) noexcept { return a |= b; }
+    friend Derived operator^(Derived a, const Derived& b) noexcept { return a ^= b; }
+
+    friend bool operator==(const Derived& a, const Derived& b) noexcept {
+        return a.size() == b.size() && std::equal(a.data(), a.data() + a.wordCount(), b.data());
+    }
+
+protected:
+    static constexpr std::size_t kLineWords = CACHE_LINE_SIZE / sizeof(Word);
+
+    static constexpr std::size_t wordsFor(std::size_t bits) noexcept {
+        const std::size_t lineBits = kLineWords * kWordBits;
+        return (bits + lineBits - 1) / lineBits * kLineWords;
+    }
+
+    // Re-establishes the zero-tail invariant after whole-word writes
+    void clearTail() noexcept {
+        Word* words = self().data();
+        std::size_t full = self().size() / kWordBits;
+        if (self().size() % kWordBits) {
+            words[full] &= (Word{1} << (self().size() % kWordBits)) - 1;
+            ++full;
+        }
+        std::fill(words + full, words + self().wordCount(), Word{0});
+    }
+
+private:
+    Derived& self() noexcept { return static_cast<Derived&>(*this); }
+    const Derived& self() const noexcept { return static_cast<const Derived&>(*this); }
+
+    Derived& apply(bitkernels::BitOp op, const Derived& other) noexcept {
+        assert(self().size() == other.size());
+        bitkernels::kernels().apply[static_cast<int>(op)](self().data(), other.data(), self().wordCount());
+        return self();
+    }
+
+    std::size_t findFrom(std::size_t start) const noexcept {
+        if (start >= self().size()) return npos;
+        const Word* words = self().data();
+        std::size_t i = start / kWordBits;
+        Word w = words[i] & (~Word{0} << (start % kWordBits));
+        while (!w) {
+            if (++i == self().wordCount()) return npos;
+            w = words[i];
+        }
+        return i * kWordBits + std::countr_zero(w);
+    }
+};
+
+/**
+ * Fixed-size bitset padded to whole, cache-line aligned lines; a drop-in for
+ * std::bitset on hot flag masks that also offers rank/select and set-bit iteration.
+ *
+ * @tparam N Number of bits
+ */
+template<std::size_t N>
+class AlignedBitset : public BitsetBase<AlignedBitset<N>> {
+    using Base = BitsetBase<AlignedBitset<N>>;
+
+public:
+    using typename Base::Word;
+    static constexpr std::size_t kWords = Base::wordsFor(N);
+
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t wordCount() const noexcept { return kWords; }
+    Word* data() noexcept { return words_.data(); }
+    const Word* data() const noexcept { return words_.data(); }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::array<Word, kWords> words_{};
+};
+
+/**
+ * Runtime-sized bitset whose words come from AlignedAllocator, replacing the
+ * bit-proxy AlignedVector<bool> for large per-instrument masks.
+ */
+class AlignedDynamicBitset : public BitsetBase<AlignedDynamicBitset> {
+public:
+    explicit AlignedDynamicBitset(std::size_t bits = 0, bool value = false) { resize(bits, value); }
+
+    /**
+     * Grows (new bits = `value`) or shrinks to `bits`.
+     */
+    void resize(std::size_t bits, bool value = false) {
+        const std::size_t oldSize = size_;
+        words_.resize(wordsFor(bits), Word{0});
+        size_ = bits;
+        if (value && bits > oldSize) {
+            std::size_t pos = oldSize;
+            for (; pos < bits && pos % kWordBits; ++pos) set(pos);
+            if (pos < bits) std::fill(words_.begin() + pos / kWordBits, words_.end(), ~Word{0});
+        }
+        clearTail();
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    std::size_t wordCount() const noexcept { return words_.size(); }
+    Word* data() noexcept { return words_.data(); }
+    const Word* data() const noexcept { return words_.data(); }
+
+private:
+    AlignedVector<Word> words_;
+    std::size_t size_ = 0;
+};
+
+// ========== AlignedRingWindow ========== //
+/**
+ * Fixed-capacity sliding window over a power-of-two ring in aligned storage, for
+ * VWAP/TWAP-style analytics over the last N events or seconds.
+ *
+ * All memory (ring plus the min/max index rings) is allocated in the constructor;
+ * push_back/pop_front/evictWhile never allocate. A push into a full window drops
+ * the oldest element.
+ *
+ * Aggregates are maintained incrementally over key(element):
+ * - sum(): running += / -= (when the key type supports them). Floating-point sums
+ *   pick up rounding over long runs; resum() recomputes from the window.
+ * - min() / max(): monotonic deques of sequence numbers, amortized O(1) per push
+ *   (when the key type is totally ordered).
+ *
+ * spans() exposes the contents, oldest first, as at most two contiguous,
+ * aligned spans for SIMD kernels.
+ *
+ * @tparam T Element type
+ * @tparam Key Projection from element to aggregated value
+ * @tparam Alignment Alignment of the ring storage
+ */
+template<typename T, typename Key = std::identity, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedRingWindow {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using key_value_type = std::decay_t<std::invoke_result_t<const Key&, const T&>>;
+
+    static constexpr bool kTracksSum = requires(key_value_type a, key_value_type b) { a += b; a -= b; };
+    static constexpr bool kTracksMinMax = std::totally_ordered<key_value_type>;
+
+    /**
+     * @param capacity Minimum capacity, rounded up to a power of two
+     */
+    explicit AlignedRingWindow(size_type capacity, Key key = Key{})
+        : mask_(std::bit_ceil(std::max<size_type>(capacity, 1)) - 1),
+          ring_(mask_ + 1),
+          key_(std::move(key)) {
+        if constexpr (kTracksMinMax) {
+            minSeq_.resize(mask_ + 1);
+            maxSeq_.resize(mask_ + 1);
+        }
+    }
+
+    size_type capacity() const noexcept { return mask_ + 1; }
+    size_type size() const noexcept { return static_cast<size_type>(tail_ - head_); }
+    bool empty() const noexcept { return tail_ == head_; }
+    bool full() const noexcept { return size() == capacity(); }
+
+    const T& front() const noexcept { return ring_[head_ & mask_]; }
+    const T& back() const noexcept { return ring_[(tail_ - 1) & mask_]; }
+
+    /**
+     * i-th element counting from the oldest.
+     */
+    const T& operator[](size_type i) const noexcept { return ring_[(head_ + i) & mask_]; }
+
+    /**
+     * Appends `value`, evicting the oldest element if the window is full.
+     */
+    void push_back(const T& value) {
+        if (full()) pop_front();
+
+        const std::uint64_t seq = tail_;
+        ring_[seq & mask_] = value;
+        ++tail_;
+
+        const key_value_type k = key_(value);
+        if constexpr (kTracksSum) sum_ += k;
+        if constexpr (kTracksMinMax) {
+            // Drop candidates the new element dominates, then append it
+            while (minTail_ != minHead_ && !(keyAt(minSeq_[(minTail_ - 1) & mask_]) < k)) --minTail_;
+            minSeq_[minTail_++ & mask_] = seq;
+            while (maxTail_ != maxHead_ && !(k < keyAt(maxSeq_[(maxTail_ - 1) & mask_]))) --maxTail_;
+            maxSeq_[maxTail_++ & mask_] = seq;
+        }
+    }
+
+    void pop_front() {
+        assert(!empty());
+        const std::uint64_t seq = head_++;
+        if constexpr (kTracksSum) sum_ -= key_(ring_[seq & mask_]);
+        if constexpr (kTracksMinMax) {
+            if (minSeq_[minHead_ & mask_] == seq) ++minHead_;
+            if (maxSeq_[maxHead_ & mask_] == seq) ++maxHead_;
+        }
+    }
+
+    /**
+     * Pops from the front while pred(front()) holds, e.g. trades older than the
+     * window start. Returns the number evicted.
+     */
+    template<typename Pred>
+    size_type evictWhile(Pred&& pred) {
+        size_type evicted = 0;
+        while (!empty() && pred(front())) {
+            pop_front();
+            ++evicted;
+        }
+        return evicted;
+    }
+
+    void clear() noexcept {
+        head_ = tail_;
+        minHead_ = minTail_;
+        maxHead_ = maxTail_;
+        if constexpr (kTracksSum) sum_ = key_value_type{};
+    }
+
+    /**
+     * Window contents oldest first: [first, second) with second empty unless the
+     * window wraps around the end of the ring.
+     */
+    std::pair<std::span<const T>, std::span<const T>> spans() const noexcept {
+        const size_type start = head_ & mask_;
+        const size_type firstLen = std::min(size(), capacity() - start);
+        return {std::span<const T>(ring_.data() + start, firstLen),
+                std::span<const T>(ring_.data(), size() - firstLen)};
+    }
+
+    key_value_type sum() const noexcept requires kTracksSum { return sum_; }
+
+    /**
+     * Recomputes the running sum from the window contents.
+     */
+    key_value_type resum() noexcept requires kTracksSum {
+        sum_ = key_value_type{};
+        for (size_type i = 0; i < size(); ++i) sum_ += key_((*this)[i]);
+        return sum_;
+    }
+
+    key_value_type min() const noexcept requires kTracksMinMax {
+        assert(!empty());
+        return keyAt(minSeq_[minHead_ & mask_]);
+    }
+
+    key_value_type max() const noexcept requires kTracksMinMax {
+        assert(!empty());
+        return keyAt(maxSeq_[maxHead_ & mask_]);
+    }
+
+private:
+    key_value_type keyAt(std::uint64_t seq) const { return key_(ring_[seq & mask_]); }
+
+    size_type mask_;
+    AlignedVector<T, Alignment> ring_;
+    std::uint64_t head_ = 0;  // Sequence of the oldest element
+    std::uint64_t tail_ = 0;  // Sequence of the next push
+
+    // Monotonic deques of sequence numbers; at most one entry per live element
+    AlignedVector<std::uint64_t> minSeq_;
+    AlignedVector<std::uint64_t> maxSeq_;
+    std::uint64_t minHead_ = 0, minTail_ = 0;
+    std::uint64_t maxHead_ = 0, maxTail_ = 0;
+
+    [[no_unique_address]] Key key_;
+    key_value_type sum_{};
+};
+
+// ========== AlignedBlockDeque ========== //
+/**
+ * Double-ended queue with a compile-time block size, drop-in for AlignedDeque
+ * where std::deque's fixed 512-byte blocks are too small (64-byte-plus elements
+ * get at most 8 per block and the deque allocates constantly).
+ *
+ * Blocks of BlockBytes come from AlignedAllocator, so every block starts on an
+ * Alignment boundary. The block map is a power-of-two ring of block pointers,
+ * giving O(1) push/pop at both ends. One emptied block is kept as a spare and
+ * reused by the next push that crosses a block boundary, so a FIFO hovering
+ * around a boundary never ping-pongs between free and alloc.
+ *
+ * Iterators are invalidated by any push or pop.
+ *
+ * @tparam T Element type
+ * @tparam BlockBytes Bytes per block (e.g. 4096 or 2 MiB)
+ * @tparam Alignment Alignment of each block
+ */
+template<typename T, std::size_t BlockBytes = MEMORY_PAGE_SIZE, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedBlockDeque {
+    using BlockAllocator = AlignedAllocator<T, Alignment>;
+
+    template<bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const AlignedBlockDeque, AlignedBlockDeque>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, std::size_t index) noexcept : owner_(owner), index_(index) {}
+        operator Iterator<true>() const noexcept requires(!Const) { return {owner_, index_}; }
+
+        reference operator*() const noexcept { return (*owner_)[index_]; }
+        pointer operator->() const noexcept { return &(*owner_)[index_]; }
+        reference operator[](difference_type n) const noexcept { return (*owner_)[index_ + n]; }
+
+        Iterator& operator++() noexcept { ++index_; return *this; }
+        Iterator operator++(int) noexcept { Iterator old = *this; ++index_; return old; }
+        Iterator& operator--() noexcept { --index_; return *this; }
+        Iterator operator--(int) noexcept { Iterator old = *this; --index_; return old; }
+        Iterator& operator+=(difference_type n) noexcept { index_ += n; return *this; }
+        Iterator& operator-=(difference_type n) noexcept { index_ -= n; return *this; }
+        friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) noexcept {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+
+        bool operator==(const Iterator& other) const noexcept { return index_ == other.index_; }
+        auto operator<=>(const Iterator& other) const noexcept { return index_ <=> other.index_; }
+
+    private:
+        Owner* owner_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using allocator_type = BlockAllocator;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    static constexpr size_type kBlockSize = BlockBytes / sizeof(T) > 0 ? BlockBytes / sizeof(T) : 1;
+
+    AlignedBlockDeque() = default;
+
+    AlignedBlockDeque(const AlignedBlockDeque& other) {
+        for (const T& value : other) push_back(value);
+    }
+
+    AlignedBlockDeque(AlignedBlockDeque&& other) noexcept { swap(other); }
+
+    AlignedBlockDeque& operator=(AlignedBlockDeque other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~AlignedBlockDeque() {
+        clear();
+        shrink_to_fit();
+    }
+
+    void swap(AlignedBlockDeque& other) noexcept {
+        map_.swap(other.map_);
+        std::swap(head_, other.head_);
+        std::swap(blocks_, other.blocks_);
+        std::swap(begin_, other.begin_);
+        std::swap(size_, other.size_);
+        std::swap(spare_, other.spare_);
+    }
+
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    T& operator[](size_type i) noexcept { return slot(begin_ + i); }
+    const T& operator[](size_type i) const noexcept { return slot(begin_ + i); }
+
+    T& at(size_type i) {
+        if (i >= size_) throw std::out_of_range("AlignedBlockDeque::at");
+        return (*this)[i];
+    }
+
+    T& front() noexcept { return (*this)[0]; }
+    const T& front() const noexcept { return (*this)[0]; }
+    T& back() noexcept { return (*this)[size_ - 1]; }
+    const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, size_}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, size_}; }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void push_front(const T& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        const size_type pos = begin_ + size_;
+        const bool newBlock = pos == blocks_ * kBlockSize;
+        if (newBlock) {
+            if (blocks_ == map_.size()) growMap();
+            map_[(head_ + blocks_) & (map_.size() - 1)] = acquireBlock();
+            ++blocks_;
+        }
+        T* p = &slot(pos);
+        try {
+            ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (newBlock) releaseBack();
+            throw;
+        }
+        ++size_;
+        return *p;
+    }
+
+    template<typename... Args>
+    T& emplace_front(Args&&... args) {
+        const bool newBlock = begin_ == 0;
+        if (newBlock) {
+            if (blocks_ == map_.size()) growMap();
+            head_ = (head_ - 1) & (map_.size() - 1);
+            map_[head_] = acquireBlock();
+            ++blocks_;
+            begin_ = kBlockSize;
+        }
+        T* p = &slot(begin_ - 1);
+        try {
+            ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (newBlock) releaseFront();
+            throw;
+        }
+        --begin_;
+        ++size_;
+        return *p;
+    }
+
+    void pop_front() noexcept {
+        assert(!empty());
+        std::destroy_at(&front());
+        ++begin_;
+        --size_;
+        if (begin_ == kBlockSize || size_ == 0) releaseFront();
+    }
+
+    void pop_back() noexcept {
+        assert(!empty());
+        std::destroy_at(&back());
+        --size_;
+        if (size_ == 0 || (begin_ + size_) % kBlockSize == 0) releaseBack();
+    }
+
+    void clear() noexcept {
+        while (!empty()) pop_back();
+    }
+
+    /**
+     * Frees the spare block and, when empty, the block map.
+     */
+    void shrink_to_fit() noexcept {
+        if (spare_) {
+            BlockAllocator().deallocate(spare_, kBlockSize);
+            spare_ = nullptr;
+        }
+        if (blocks_ == 0) {
+            map_.clear();
+            map_.shrink_to_fit();
+            head_ = 0;
+        }
+    }
+
+private:
+    T& slot(size_type pos) const noexcept {
+        return map_[(head_ + pos / kBlockSize) & (map_.size() - 1)][pos % kBlockSize];
+    }
+
+    T* acquireBlock() {
+        if (T* block = std::exchange(spare_, nullptr)) return block;
+        return BlockAllocator().allocate(kBlockSize);
+    }
+
+    // Keeps one empty block for the next boundary crossing, frees the rest
+    void recycleBlock(T* block) noexcept {
+        if (!spare_) {
+            spare_ = block;
+        } else {
+            BlockAllocator().deallocate(block, kBlockSize);
+        }
+    }
+
+    void releaseFront() noexcept {
+        recycleBlock(map_[head_]);
+        head_ = (head_ + 1) & (map_.size() - 1);
+        --blocks_;
+        begin_ = 0;
+    }
+
+    void releaseBack() noexcept {
+        --blocks_;
+        recycleBlock(map_[(head_ + blocks_) & (map_.size() - 1)]);
+        if (blocks_ == 0) begin_ = 0;
+    }
+
+    // Doubles the pointer ring and unrolls the live blocks to the start
+    void growMap() {
+        AlignedVector<T*> grown(map_.empty() ? 8 : map_.size() * 2, nullptr);
+        for (size_type i = 0; i < blocks_; ++i) grown[i] = map_[(head_ + i) & (map_.size() - 1)];
+        map_.swap(grown);
+        head_ = 0;
+    }
+
+    AlignedVector<T*> map_;    // Ring of block pointers, power-of-two size
+    size_type head_ = 0;       // Map index of the first live block
+    size_type blocks_ = 0;     // Live blocks
+    size_type begin_ = 0;      // Offset of front() inside the first block
+    size_type size_ = 0;
+    T* spare_ = nullptr;       // Recycled empty block
+};
+
+// FIFO on the block deque: pass the block size that suits the element, e.g. 2 MiB for huge pages
+template<typename T, std::size_t BlockBytes = MEMORY_PAGE_SIZE, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedBlockQueue = AlignedQueue<T, Alignment, AlignedBlockDeque<T, BlockBytes, Alignment>>;
+
+// ========== Intrusive Containers ========== //
+/**
+ * Hook embedded in objects linked into an IntrusiveList.
+ * Derive from it: `struct Order : ListHook<> { ... };`. An object can sit in
+ * several lists at once by deriving from hooks with different tags:
+ * `struct Order : ListHook<BidSide>, ListHook<PriceLevel> { ... };`
+ *
+ * @tparam Tag Distinguishes multiple hooks in the same object
+ */
+template<typename Tag = void>
+struct ListHook {
+    ListHook* listPrev = nullptr;
+    ListHook* listNext = nullptr;  // nullptr while unlinked
+
+    ListHook() = default;
+    // Links belong to the object, not its value: a copy starts unlinked, assignment keeps the target's links
+    ListHook(const ListHook&) noexcept {}
+    ListHook& operator=(const ListHook&) noexcept { return *this; }
+};
+
+/**
+ * Doubly-linked list threading through hooks embedded in the elements.
+ *
+ * Linking and unlinking never allocate, and erase() is O(1) given the element,
+ * so with elements from AlignedObjectPool an order queue never calls the
+ * allocator. The list does not own its elements: they must outlive their
+ * membership and be erased (or the list cleared) before being destroyed.
+ *
+ * @tparam T Element type, must derive from ListHook<Tag>
+ * @tparam Tag Which of the element's list hooks to use
+ */
+template<typename T, typename Tag = void>
+class IntrusiveList {
+    using Hook = ListHook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "IntrusiveList elements must derive from ListHook<Tag>");
+
+    template<bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() = default;
+        explicit Iterator(Hook* node) noexcept : node_(node) {}
+        operator Iterator<true>() const noexcept requires(!Const) { return Iterator<true>(node_); }
+
+        reference operator*() const noexcept { return *static_cast<pointer>(node_); }
+        pointer operator->() const noexcept { return static_cast<pointer>(node_); }
+
+        Iterator& operator++() noexcept { node_ = node_->listNext; return *this; }
+        Iterator operator++(int) noexcept { Iterator old = *this; ++*this; return old; }
+        Iterator& operator--() noexcept { node_ = node_->listPrev; return *this; }
+        Iterator operator--(int) noexcept { Iterator old = *this; --*this; return old; }
+
+        bool operator==(const Iterator& other) const noexcept { return node_ == other.node_; }
+
+    private:
+        friend class IntrusiveList;
+        Hook* node_ = nullptr;
+    };
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    IntrusiveList() noexcept { root_.listPrev = root_.listNext = &root_; }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    ~IntrusiveList() { clear(); }
+
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    iterator begin() noexcept { return iterator(root_.listNext); }
+    iterator end() noexcept { return iterator(&root_); }
+    const_iterator begin() const noexcept { return const_iterator(root_.listNext); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<Hook*>(&root_)); }
+
+    T& front() noexcept { return *static_cast<T*>(root_.listNext); }
+    T& back() noexcept { return *static_cast<T*>(root_.listPrev); }
+
+    void push_back(T& item) noexcept { linkBefore(&root_, item); }
+    void push_front(T& item) noexcept { linkBefore(root_.listNext, item); }
+
+    /**
+     * Links `item` before `pos`; returns an iterator to it.
+     */
+    iterator insert(const_iterator pos, T& item) noexcept {
+        linkBefore(pos.node_, item);
+        return iterator(static_cast<Hook*>(&item));
+    }
+
+    void pop_front() noexcept { erase(front()); }
+    void pop_back() noexcept { erase(back()); }
+
+    /**
+     * Unlinks `item` in O(1); returns an iterator to the element after it.
+     */
+    iterator erase(T& item) noexcept {
+        Hook* node = static_cast<Hook*>(&item);
+        assert(isLinked(item));
+        Hook* next = node->listNext;
+        node->listPrev->listNext = next;
+        next->listPrev = node->listPrev;
+        node->listPrev = node->listNext = nullptr;
+        --size_;
+        return iterator(next);
+    }
+
+    /**
+     * Unlinks every element (elements themselves are untouched).
+     */
+    void clear() noexcept {
+        while (!empty()) pop_front();
+    }
+
+    static bool isLinked(const T& item) noexcept { return static_cast<const Hook&>(item).listNext != nullptr; }
+
+private:
+    void linkBefore(Hook* pos, T& item) noexcept {
+        Hook* node = static_cast<Hook*>(&item);
+        assert(!isLinked(item));
+        node->listNext = pos;
+        node->listPrev = pos->listPrev;
+        pos->listPrev->listNext = node;
+        pos->listPrev = node;
+        ++size_;
+    }
+
+    Hook root_;  // Sentinel: root_.listNext is front, root_.listPrev is back
+    size_type size_ = 0;
+};
+
+/**
+ * Hook embedded in objects linked into an IntrusiveHashTable; caches the hash
+ * so chain walks and rehashing never recompute it.
+ *
+ * @tparam Tag Distinguishes multiple hooks in the same object
+ */
+template<typename Tag = void>
+struct HashHook {
+    HashHook* hashNext = nullptr;
+    std::size_t hashValue = 0;
+
+    HashHook() = default;
+    // As ListHook: copies start unlinked, assignment leaves the target's membership alone
+    HashHook(const HashHook&) noexcept {}
+    HashHook& operator=(const HashHook&) noexcept { return *this; }
+};
+
+/**
+ * Chained hash table over hooks embedded in the elements, keyed by
+ * KeyOf{}(element) (e.g. the order id).
+ *
+ * Only the bucket array is allocated (aligned, in the constructor and in
+ * rehash()); insert/find/erase never allocate. The table does not grow on its
+ * own, so size it for the expected population up front and call rehash() off
+ * the hot path if the load factor drifts up.
+ *
+ * @tparam T Element type, must derive from HashHook<Tag>
+ * @tparam KeyOf Functor returning the element's key
+ * @tparam Hash Hash functor for the key
+ * @tparam KeyEqual Equality for keys
+ * @tparam Tag Which of the element's hash hooks to use
+ */
+template<typename T, typename KeyOf, typename Hash = std::hash<std::decay_t<std::invoke_result_t<KeyOf, const T&>>>,
+         typename KeyEqual = std::equal_to<>, typename Tag = void>
+class IntrusiveHashTable {
+    using Hook = HashHook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "IntrusiveHashTable elements must derive from HashHook<Tag>");
+
+public:
+    using key_type = std::decay_t<std::invoke_result_t<KeyOf, const T&>>;
+    using size_type = std::size_t;
+
+    /**
+     * @param buckets Initial bucket count, rounded up to a power of two
+     */
+    explicit IntrusiveHashTable(size_type buckets = 1024) { rehash(buckets); }
+
+    IntrusiveHashTable(const IntrusiveHashTable&) = delete;
+    IntrusiveHashTable& operator=(const IntrusiveHashTable&) = delete;
+
+    ~IntrusiveHashTable() { clear(); }
+
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_type bucket_count() const noexcept { return buckets_.size(); }
+    double load_factor() const noexcept { return static_cast<double>(size_) / static_cast<double>(buckets_.size()); }
+
+    /**
+     * Links `item` unless an element with the same key is present.
+     * @return false (and leaves `item` unlinked) on a duplicate key
+     */
+    bool insert(T& item) noexcept {
+        const std::size_t hash = hasher_(keyOf_(item));
+        Hook*& head = buckets_[hash & mask_];
+        for (Hook* node = head; node; node = node->hashNext) {
+            if (node->hashValue == hash && equal_(keyOf_(*static_cast<T*>(node)), keyOf_(item))) return false;
+        }
+        Hook* hook = static_cast<Hook*>(&item);
+        hook->hashValue = hash;
+        hook->hashNext = head;
+        head = hook;
+        ++size_;
+        return true;
+    }
+
+    template<typename K>
+    T* find(const K& key) const noexcept {
+        const std::size_t hash = hasher_(key);
+        for (Hook* node = buckets_[hash & mask_]; node; node = node->hashNext) {
+            if (node->hashValue == hash && equal_(keyOf_(*static_cast<T*>(node)), key)) return static_cast<T*>(node);
+        }
+        return nullptr;
+    }
+
+    template<typename K>
+    bool contains(const K& key) const noexcept { return find(key) != nullptr; }
+
+    /**
+     * Unlinks `item`, which must be in this table.
+     */
+    void erase(T& item) noexcept {
+        Hook* hook = static_cast<Hook*>(&item);
+        Hook** link = &buckets_[hook->hashValue & mask_];
+        while (*link != hook) link = &(*link)->hashNext;
+        *link = hook->hashNext;
+        hook->hashNext = nullptr;
+        --size_;
+    }
+
+    /**
+     * Unlinks and returns the element with `key`, or nullptr.
+     */
+    template<typename K>
+    T* erase(const K& key) noexcept {
+        T* item = find(key);
+        if (item) erase(*item);
+        return item;
+    }
+
+    template<typename F>
+    void forEach(F&& fn) const {
+        for (Hook* head : buckets_) {
+            for (Hook* node = head; node;) {
+                Hook* next = node->hashNext;  // fn may unlink the element
+                fn(*static_cast<T*>(node));
+                node = next;
+            }
+        }
+    }
+
+    /**
+     * Unlinks every element (elements themselves are untouched).
+     */
+    void clear() noexcept {
+        for (Hook*& head : buckets_) {
+            while (head) head = std::exchange(head->hashNext, nullptr);
+        }
+        size_ = 0;
+    }
+
+    /**
+     * Resizes the bucket array (allocates) and relinks every element using the
+     * cached hashes.
+     */
+    void rehash(size_type buckets) {
+        AlignedVector<Hook*> grown(std::bit_ceil(std::max<size_type>(buckets, 1)), nullptr);
+        const size_type mask = grown.size() - 1;
+        for (Hook* head : buckets_) {
+            while (head) {
+                Hook* next = head->hashNext;
+                head->hashNext = grown[head->hashValue & mask];
+                grown[head->hashValue & mask] = head;
+                head = next;
+            }
+        }
+        buckets_.swap(grown);
+        mask_ = mask;
+    }
+
+private:
+    AlignedVector<Hook*> buckets_;
+    size_type mask_ = 0;
+    size_type size_ = 0;
+    [[no_unique_address]] KeyOf keyOf_;
+    [[no_unique_address]] Hash hasher_;
+    [[no_unique_address]] KeyEqual equal_;
+};
+
+// ========== ConcurrentSkipListMap ========== //
+/**
+ * Epoch-based reclamation for structures whose readers traverse without locks.
+ *
+ * Each reader owns a padded slot and publishes the global epoch in it for the
+ * duration of an operation. Memory unlinked by the writer is retired into the
+ * current epoch's limbo list and freed two epoch advances later, when no reader
+ * can still hold a pointer to it. The epoch only advances once every active
+ * reader has caught up, so a stalled reader delays reclamation but never
+ * blocks the writer.
+ *
+ * retire() and tryAdvance() must be serialized (single writer or writer lock).
+ * At most kMaxReaders slots exist; claiming one more throws.
+ */
+class EpochReclaimer {
+public:
+    static constexpr std::size_t kMaxReaders = 64;
+
+    EpochReclaimer() = default;
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    ~EpochReclaimer() {
+        for (auto& bucket : limbo_) reclaim(bucket);
+    }
+
+    /**
+     * Claims a reader slot.
+     * @throws std::runtime_error if all kMaxReaders slots are taken
+     */
+    std::size_t acquireSlot() {
+        for (std::size_t i = 0; i < kMaxReaders; ++i) {
+            bool expected = false;
+            if (slots_[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) return i;
+        }
+        throw std::runtime_error("EpochReclaimer: reader slots exhausted");
+    }
+
+    void releaseSlot(std::size_t slot) noexcept {
+        slots_[slot].epoch.store(kIdle, std::memory_order_release);
+        slots_[slot].claimed.store(false, std::memory_order_release);
+    }
+
+    void enter(std::size_t slot) noexcept {
+        slots_[slot].epoch.store(epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // The published epoch must be visible before any shared pointer is read
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void exit(std::size_t slot) noexcept { slots_[slot].epoch.store(kIdle, std::memory_order_release); }
+
+    /**
+     * Defers reclaim(p) until no reader can reach p. p must already be unlinked.
+     */
+    void retire(void* p, void (*reclaim)(void*)) {
+        auto& bucket = limbo_[epoch_.load(std::memory_order_relaxed) % 3];
+        bucket.push_back({p, reclaim});
+        if (bucket.size() >= kAdvanceBatch) tryAdvance();
+    }
+
+    /**
+     * Advances the epoch if every active reader has observed the current one,
+     * then frees what was retired two epochs ago.
+     */
+    bool tryAdvance() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Unlinks visible before the slot scan
+        const std::uint64_t current = epoch_.load(std::memory_order_relaxed);
+        for (const Slot& slot : slots_) {
+            const std::uint64_t observed = slot.epoch.load(std::memory_order_acquire);
+            if (observed != kIdle && observed != current) return false;
+        }
+        epoch_.store(current + 1, std::memory_order_release);
+        reclaim(limbo_[(current + 1) % 3]);
+        return true;
+    }
+
+private:
+    static constexpr std::uint64_t kIdle = ~std::uint64_t{0};
+    static constexpr std::size_t kAdvanceBatch = 64;
+
+    struct Retired {
+        void* p;
+        void (*reclaim)(void*);
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::uint64_t> epoch{kIdle};
+        std::atomic<bool> claimed{false};
+    };
+
+    static void reclaim(AlignedVector<Retired>& bucket) noexcept {
+        for (const Retired& r : bucket) r.reclaim(r.p);
+        bucket.clear();
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> epoch_{0};
+    std::array<Slot, kMaxReaders> slots_;
+    std::array<AlignedVector<Retired>, 3> limbo_;
+};
+
+/**
+ * Ordered map (skiplist) readable by many threads while writers update it,
+ * e.g. the price levels of a book scanned by strategy threads.
+ *
+ * Readers traverse atomic tower links under an epoch guard (EpochReclaimer), so
+ * unlinked nodes stay valid until no reader can see them. Every node carries
+ * its own version counter, bumped (odd while in progress) when the writer
+ * changes its value or its level-0 link, and tagged dead when it is erased:
+ *  - find() never retries on other keys' writes; it only waits out a
+ *    concurrent update of the node it found, so multi-word values do not tear.
+ *  - range() records the version of each level-0 node it passes (from the
+ *    predecessor of lo on) and re-checks them at the end, so it is a snapshot
+ *    of [lo, hi) and only writes inside that interval force a retry. Retries
+ *    stay optimistic (yielding after kRangeAttempts), so readers never block
+ *    the writer; a range under constant writes may take several passes.
+ * Writers serialize on a SpinLock. At most EpochReclaimer::kMaxReaders (64)
+ * Readers can exist at once.
+ *
+ * Nodes are cache-line aligned and come from Backend (the pooled slab engine by
+ * default), one size class per tower height. Value words, key, height, version
+ * and the level-0 link come first, so a level-0 walk touches one line per node while
+ * the key and value fit in 40 bytes; levels are drawn with p = 1/4, so three
+ * nodes in four have no upper tower.
+ *
+ * @tparam Key Trivially copyable key
+ * @tparam T Trivially copyable mapped value (stored as atomic words)
+ * @tparam Compare Strict weak ordering on keys
+ * @tparam Backend Node storage (static allocate/deallocate)
+ */
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Backend = PooledAlignedBackend>
+class ConcurrentSkipListMap {
+    static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>,
+                  "ConcurrentSkipListMap requires trivially copyable keys and values");
+
+    static constexpr int kMaxLevel = 16;
+    static constexpr int kRangeAttempts = 4;  // Back-to-back range() passes before yielding between retries
+    static constexpr std::size_t kValueWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    static constexpr std::uint32_t kWriting = 1;         // Version bit: value or level-0 link being changed
+    static constexpr std::uint32_t kDead = 1u << 31;     // Version bit: erased
+
+    struct Node {
+        std::atomic<std::uint64_t> value[kValueWords];
+        Key key;
+        int level;
+        std::atomic<std::uint32_t> version{0};
+        // Followed by `level` std::atomic<Node*> links
+
+        std::atomic<Node*>* links() noexcept {
+            return reinterpret_cast<std::atomic<Node*>*>(reinterpret_cast<std::byte*>(this) + kLinksOffset);
+        }
+    };
+
+    static constexpr std::size_t kLinksOffset =
+        (sizeof(Node) + alignof(std::atomic<Node*>) - 1) / alignof(std::atomic<Node*>) * alignof(std::atomic<Node*>);
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+
+    /**
+     * Per-thread read handle; owns one of the EpochReclaimer::kMaxReaders
+     * reclaimer slots for its lifetime.
+     * @throws std::runtime_error (constructor) if all reader slots are taken
+     */
+    class Reader {
+    public:
+        explicit Reader(const ConcurrentSkipListMap& map) : map_(&map), slot_(map.reclaimer_.acquireSlot()) {}
+        ~Reader() { map_->reclaimer_.releaseSlot(slot_); }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        std::optional<T> find(const Key& key) const {
+            Guard guard(*this);
+            Node* node = map_->lowerBound(key);
+            if (!node || map_->comp_(key, node->key) || map_->comp_(node->key, key)) return std::nullopt;
+            return readValue(node);
+        }
+
+        bool contains(const Key& key) const { return find(key).has_value(); }
+
+        /**
+         * Replaces `out` with up to `limit` entries with lo <= key < hi, in key
+         * order, as of a single point in time.
+         * @tparam Container push_back-able container of std::pair<Key, T>
+         */
+        template<typename Container>
+        void range(const Key& lo, const Key& hi, Container& out,
+                   std::size_t limit = std::numeric_limits<std::size_t>::max()) const {
+            Guard guard(*this);
+            for (int attempt = 0; !tryRange(lo, hi, out, limit); ++attempt) {
+                if (attempt >= kRangeAttempts) std::this_thread::yield();  // Writes keep landing in [lo, hi)
+            }
+        }
+
+    private:
+        struct Guard {
+            explicit Guard(const Reader& r) noexcept : reader(r) { reader.map_->reclaimer_.enter(reader.slot_); }
+            ~Guard() { reader.map_->reclaimer_.exit(reader.slot_); }
+            const Reader& reader;
+        };
+
+        // Versions of the level-0 chain read, re-checked at the end: unchanged means no write touched it.
+        // Nodes below lo (inserted after the predecessor was found) are validated but not reported.
+        template<typename Container>
+        bool tryRange(const Key& lo, const Key& hi, Container& out, std::size_t limit) const {
+            out.clear();
+            visited_.clear();
+            Node* node = map_->lowerBoundPredecessor(lo);
+            for (bool predecessor = true;; predecessor = false) {
+                const std::uint32_t version = node->version.load(std::memory_order_acquire);
+                if (version & (kWriting | kDead)) return false;
+                visited_.push_back({node, version});
+                if (!predecessor && !map_->comp_(node->key, lo)) out.push_back({node->key, loadValue(node)});
+                if (out.size() == limit) break;
+                node = node->links()[0].load(std::memory_order_acquire);
+                if (!node || !map_->comp_(node->key, hi)) break;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);  // Reads complete before the re-check
+            for (const auto& [seen, version] : visited_) {
+                if (seen->version.load(std::memory_order_relaxed) != version) return false;
+            }
+            return true;
+        }
+
+        // Seqlock read of one node's value; waits out an in-place update (not erasure)
+        static T readValue(Node* node) noexcept {
+            if constexpr (kValueWords == 1) {
+                return loadValue(node);
+            } else {
+                for (;;) {
+                    const std::uint32_t version = node->version.load(std::memory_order_acquire);
+                    if (version & kWriting) continue;
+                    const T value = loadValue(node);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (node->version.load(std::memory_order_relaxed) == version) return value;
+                }
+            }
+        }
+
+        const ConcurrentSkipListMap* map_;
+        std::size_t slot_;
+        mutable AlignedVector<std::pair<Node*, std::uint32_t>> visited_;  // Scratch for range()
+    };
+
+    ConcurrentSkipListMap() : head_(createNode(Key{}, T{}, kMaxLevel)) {}
+
+    ConcurrentSkipListMap(const ConcurrentSkipListMap&) = delete;
+    ConcurrentSkipListMap& operator=(const ConcurrentSkipListMap&) = delete;
+
+    /**
+     * Frees every node; no Reader may outlive the map.
+     */
+    ~ConcurrentSkipListMap() {
+        Node* node = head_;
+        while (node) {
+            Node* next = node->links()[0].load(std::memory_order_relaxed);
+            destroyNode(node);
+            node = next;
+        }
+    }
+
+    /**
+     * Inserts or overwrites. Returns true if the key was new.
+     */
+    bool insert_or_assign(const Key& key, const T& value) {
+        std::lock_guard<SpinLock> lock(writerLock_);
+        Node* preds[kMaxLevel];
+        Node* found = findPredecessors(key, preds);
+
+        if (found) {
+            beginWrite(found);
+            storeValue(found, value);
+            endWrite(found);
+            return false;
+        }
+
+        const int level = randomLevel();
+        Node* node = createNode(key, value, level);
+        for (int i = 0; i < level; ++i) {
+            node->links()[i].store(preds[i]->links()[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        beginWrite(preds[0]);
+        for (int i = 0; i < level; ++i) preds[i]->links()[i].store(node, std::memory_order_release);
+        endWrite(preds[0]);
+        size_.store(size_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Unlinks `key`; the node is reclaimed once no reader can reach it.
+     */
+    bool erase(const Key& key) {
+        std::lock_guard<SpinLock> lock(writerLock_);
+        Node* preds[kMaxLevel];
+        Node* found = findPredecessors(key, preds);
+        if (!found) return false;
+
+        beginWrite(found);
+        beginWrite(preds[0]);
+        for (int i = found->level - 1; i >= 0; --i) {
+            preds[i]->links()[i].store(found->links()[i].load(std::memory_order_relaxed), std::memory_order_release);
+        }
+        endWrite(preds[0]);
+        endWrite(found, kDead);
+        size_.store(size_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        reclaimer_.retire(found, &reclaimNode);
+        return true;
+    }
+
+    std::size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+    bool empty() const noexcept { return size() == 0; }
+
+private:
+    static std::size_t nodeBytes(int level) noexcept { return kLinksOffset + level * sizeof(std::atomic<Node*>); }
+
+    static Node* createNode(const Key& key, const T& value, int level) {
+        void* raw = Backend::allocate(nodeBytes(level), CACHE_LINE_SIZE);
+        Node* node = ::new (raw) Node;
+        node->key = key;
+        node->level = level;
+        for (int i = 0; i < level; ++i) ::new (static_cast<void*>(&node->links()[i])) std::atomic<Node*>(nullptr);
+        storeValue(node, value);
+        return node;
+    }
+
+    static void destroyNode(Node* node) noexcept {
+        const std::size_t bytes = nodeBytes(node->level);
+        node->~Node();
+        Backend::deallocate(node, bytes, CACHE_LINE_SIZE);
+    }
+
+    static void reclaimNode(void* p) { destroyNode(static_cast<Node*>(p)); }
+
+    static void storeValue(Node* node, const T& value) noexcept {
+        std::uint64_t buffer[kValueWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (std::size_t i = 0; i < kValueWords; ++i) node->value[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    static T loadValue(Node* node) noexcept {
+        std::uint64_t buffer[kValueWords];
+        for (std::size_t i = 0; i < kValueWords; ++i) buffer[i] = node->value[i].load(std::memory_order_relaxed);
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // Last node with key < `key` on level 0 (head_ if none)
+    Node* lowerBoundPredecessor(const Key& key) const noexcept {
+        Node* x = head_;
+        for (int i = topLevel_.load(std::memory_order_acquire) - 1; i >= 0; --i) {
+            for (Node* next = x->links()[i].load(std::memory_order_acquire); next && comp_(next->key, key);
+                 next = x->links()[i].load(std::memory_order_acquire)) {
+                x = next;
+            }
+        }
+        return x;
+    }
+
+    // First node with key >= `key` (nullptr if none); steps past nodes inserted after the predecessor was found
+    Node* lowerBound(const Key& key) const noexcept {
+        Node* node = lowerBoundPredecessor(key)->links()[0].load(std::memory_order_acquire);
+        while (node && comp_(node->key, key)) node = node->links()[0].load(std::memory_order_acquire);
+        return node;
+    }
+
+    // Writer side: fills the rightmost node before `key` on every level
+    Node* findPredecessors(const Key& key, Node** preds) const noexcept {
+        Node* x = head_;
+        for (int i = kMaxLevel - 1; i >= 0; --i) {
+            for (Node* next = x->links()[i].load(std::memory_order_relaxed); next && comp_(next->key, key);
+                 next = x->links()[i].load(std::memory_order_relaxed)) {
+                x = next;
+            }
+            preds[i] = x;
+        }
+        Node* candidate = x->links()[0].load(std::memory_order_relaxed);
+        return candidate && !comp_(key, candidate->key) ? candidate : nullptr;
+    }
+
+    int randomLevel() noexcept {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 7;
+        rng_ ^= rng_ << 17;
+        const int level = std::min(1 + std::countr_zero(rng_ | (std::uint64_t{1} << 62)) / 2, kMaxLevel);
+        if (level > topLevel_.load(std::memory_order_relaxed)) topLevel_.store(level, std::memory_order_release);
+        return level;
+    }
+
+    // Per-node versions: the counter steps by 2 per write (kWriting set in between), wrapping below kDead
+    static void beginWrite(Node* node) noexcept {
+        node->version.store(node->version.load(std::memory_order_relaxed) | kWriting, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);  // Odd version visible before the mutation
+    }
+
+    static void endWrite(Node* node, std::uint32_t flags = 0) noexcept {
+        const std::uint32_t next = ((node->version.load(std::memory_order_relaxed) + 1) & ~kDead) | flags;
+        node->version.store(next, std::memory_order_release);
+    }
+
+    std::atomic<int> topLevel_{1};
+    Node* head_;
+    Compare comp_{};
+
+    SpinLock writerLock_;
+    std::uint64_t rng_ = 0x9E3779B97F4A7C15ull;
+    std::atomic<std::size_t> size_{0};
+    mutable EpochReclaimer reclaimer_;
+};
+
+// ========== Symbol Interning ========== //
+/**
+ * Bump allocator for immutable strings, packed back to back in cache-line
+ * aligned chunks from AlignedAllocator.
+ *
+ * Stored strings never move, so the returned views stay valid until clear() or
+ * destruction, and each is NUL-terminated for C APIs. Strings longer than a
+ * chunk get a dedicated chunk. Not thread-safe; guard it externally or give
+ * each thread (or shard) its own arena.
+ */
+class AlignedStringArena {
+public:
+    explicit AlignedStringArena(std::size_t chunkBytes = 64 * 1024) : chunkBytes_(chunkBytes) {}
+
+    AlignedStringArena(const AlignedStringArena&) = delete;
+    AlignedStringArena& operator=(const AlignedStringArena&) = delete;
+
+    AlignedStringArena(AlignedStringArena&& other) noexcept
+        : chunkBytes_(other.chunkBytes_), chunks_(std::move(other.chunks_)), current_(other.current_),
+          used_(other.used_), bytesStored_(other.bytesStored_) {
+        other.chunks_.clear();
+        other.current_ = other.used_ = other.bytesStored_ = 0;
+    }
+
+    ~AlignedStringArena() {
+        for (const Chunk& chunk : chunks_) AlignedAllocator<char>().deallocate(chunk.data, chunk.size);
+    }
+
+    /**
+     * Copies `s` (plus a NUL) into the arena and returns a view of the copy.
+     */
+    std::string_view store(std::string_view s) {
+        char* p = reserve(s.size() + 1);
+        std::memcpy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        bytesStored_ += s.size();
+        return {p, s.size()};
+    }
+
+    /**
+     * Forgets every stored string but keeps the chunks for reuse.
+     */
+    void clear() noexcept {
+        current_ = 0;
+        used_ = 0;
+        bytesStored_ = 0;
+    }
+
+    std::size_t bytesStored() const noexcept { return bytesStored_; }
+
+    std::size_t bytesReserved() const noexcept {
+        std::size_t total = 0;
+        for (const Chunk& chunk : chunks_) total += chunk.size;
+        return total;
+    }
+
+private:
+    struct Chunk {
+        char* data;
+        std::size_t size;
+    };
+
+    char* reserve(std::size_t bytes) {
+        while (current_ < chunks_.size()) {
+            Chunk& chunk = chunks_[current_];
+            if (chunk.size - used_ >= bytes) {
+                char* p = chunk.data + used_;
+                used_ += bytes;
+                return p;
+            }
+            ++current_;  // Tail of this chunk is abandoned until clear()
+            used_ = 0;
+        }
+        const std::size_t size = std::max(chunkBytes_, bytes);
+        chunks_.push_back({AlignedAllocator<char>().allocate(size), size});
+        current_ = chunks_.size() - 1;
+        used_ = bytes;
+        return chunks_.back().data;
+    }
+
+    std::size_t chunkBytes_;
+    AlignedVector<Chunk> chunks_;
+    std::size_t current_ = 0;  // Chunk being filled
+    std::size_t used_ = 0;     // Bytes used in it
+    std::size_t bytesStored_ = 0;
+};
+
+using SymbolId = std::uint32_t;
+
+/**
+ * Thread-safe string interning: maps each distinct string to a dense 32-bit id
+ * (0, 1, 2, ... in first-intern order) so hot tables can key on integers
+ * (AlignedVector indexed by id, AlignedUnorderedMap<SymbolId, ...>).
+ *
+ * The table is split into kShards shards by hash, each with its own SpinLock,
+ * string arena and open-addressing index of (hash tag, id) pairs packed eight to
+ * a cache line, so concurrent intern/find calls on different symbols rarely
+ * contend. Names live in a segmented id -> string_view directory that never
+ * relocates, so name(id) takes no lock.
+ */
+class SymbolTable {
+public:
+    static constexpr std::size_t kShards = 16;
+
+    SymbolTable() = default;
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    ~SymbolTable() {
+        for (std::size_t s = 0; s < kSegments; ++s) {
+            if (Name* segment = segments_[s].load(std::memory_order_relaxed)) {
+                AlignedAllocator<Name>().deallocate(segment, segmentSize(s));
+            }
+        }
+    }
+
+    /**
+     * Id of `name`, assigning the next id on first sight.
+     * @throws std::length_error once 2^32 - 1 symbols exist
+     */
+    SymbolId intern(std::string_view name) {
+        const std::size_t hash = std::hash<std::string_view>{}(name);
+        Shard& shard = shards_[shardOf(hash)];
+        std::lock_guard<SpinLock> lock(shard.lock);
+
+        if (const SymbolId* id = shard.find(hash, name, *this)) return *id;
+
+        const std::uint64_t next = nextId_.fetch_add(1, std::memory_order_relaxed);
+        if (next >= kInvalidSymbol) throw std::length_error("SymbolTable: symbol ids exhausted");
+        const SymbolId id = static_cast<SymbolId>(next);
+        slot(id) = Name{shard.arena.store(name)};
+        shard.insert(hash, id);
+        return id;
+    }
+
+    /**
+     * Id of `name` if it has been interned.
+     */
+    std::optional<SymbolId> find(std::string_view name) const {
+        const std::size_t hash = std::hash<std::string_view>{}(name);
+        Shard& shard = shards_[shardOf(hash)];
+        std::lock_guard<SpinLock> lock(shard.lock);
+        if (const SymbolId* id = shard.find(hash, name, *this)) return *id;
+        return std::nullopt;
+    }
+
+    /**
+     * String for an id returned by intern()/find(); NUL-terminated, lock-free.
+     */
+    std::string_view name(SymbolId id) const noexcept {
+        const auto [s, offset] = locate(id);
+        return segments_[s].load(std::memory_order_acquire)[offset].view;
+    }
+
+    /**
+     * Number of ids handed out; every id below this is valid once the intern()
+     * that produced it has returned.
+     */
+    std::size_t size() const noexcept { return nextId_.load(std::memory_order_relaxed); }
+
+    static constexpr SymbolId kInvalidSymbol = std::numeric_limits<SymbolId>::max();
+
+private:
+    struct Name {
+        std::string_view view;
+    };
+
+    // Directory segment s holds kFirstSegment << s names; 23 segments cover 2^32 ids
+    static constexpr std::size_t kFirstSegmentBits = 10;
+    static constexpr std::size_t kSegments = 32 - kFirstSegmentBits + 1;
+
+    static constexpr std::size_t segmentSize(std::size_t s) noexcept {
+        return std::size_t{1} << (s + kFirstSegmentBits);
+    }
+
+    // (segment, offset) of an id in the name directory
+    static std::pair<std::size_t, std::size_t> locate(SymbolId id) noexcept {
+        const std::uint64_t index = std::uint64_t{id} + (std::uint64_t{1} << kFirstSegmentBits);
+        const std::size_t s = std::bit_width(index) - 1 - kFirstSegmentBits;
+        return {s, static_cast<std::size_t>(index - segmentSize(s))};
+    }
+
+    // Directory entry for a new id, allocating its segment on first use
+    Name& slot(SymbolId id) {
+        const auto [s, offset] = locate(id);
+        Name* segment = segments_[s].load(std::memory_order_acquire);
+        if (!segment) {
+            Name* fresh = AlignedAllocator<Name>().allocate(segmentSize(s));
+            std::uninitialized_value_construct_n(fresh, segmentSize(s));
+            if (segments_[s].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel)) {
+                segment = fresh;
+            } else {
+                AlignedAllocator<Name>().deallocate(fresh, segmentSize(s));  // Another shard won the race
+            }
+        }
+        return segment[offset];
+    }
+
+    // High hash bits pick the shard, low bits the slot inside it
+    static std::size_t shardOf(std::size_t hash) noexcept {
+        return (hash >> (std::numeric_limits<std::size_t>::digits / 2)) % kShards;
+    }
+
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        struct Entry {
+            std::uint32_t tag;  // Low hash bits, saves most string compares
+            SymbolId id;        // kInvalidSymbol marks an empty entry
+        };
+
+        mutable SpinLock lock;
+        AlignedVector<Entry> entries;
+        std::size_t count = 0;
+        AlignedStringArena arena{16 * 1024};
+
+        const SymbolId* find(std::size_t hash, std::string_view name, const SymbolTable& table) const {
+            if (entries.empty()) return nullptr;
+            const std::size_t mask = entries.size() - 1;
+            const auto tag = static_cast<std::uint32_t>(hash);
+            for (std::size_t i = tag & mask;; i = (i + 1) & mask) {
+                const Entry& e = entries[i];
+                if (e.id == kInvalidSymbol) return nullptr;
+                if (e.tag == tag && table.name(e.id) == name) return &e.id;
+            }
+        }
+
+        void insert(std::size_t hash, SymbolId id) {
+            if ((count + 1) * 4 > entries.size() * 3) grow();  // Keep load under 3/4
+            place(static_cast<std::uint32_t>(hash), id);
+            ++count;
+        }
+
+        void place(std::uint32_t tag, SymbolId id) {
+            const std::size_t mask = entries.size() - 1;
+            std::size_t i = tag & mask;
+            while (entries[i].id != kInvalidSymbol) i = (i + 1) & mask;
+            entries[i] = {tag, id};
+        }
+
+        // The tag holds every index bit, so growing never rehashes strings
+        void grow() {
+            AlignedVector<Entry> old(std::max<std::size_t>(entries.size() * 2, 64), Entry{0, kInvalidSymbol});
+            old.swap(entries);
+            for (const Entry& e : old) {
+                if (e.id != kInvalidSymbol) place(e.tag, e.id);
+            }
+        }
+    };
+
+    mutable std::array<Shard, kShards> shards_;
+    std::atomic<Name*> segments_[kSegments] = {};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> nextId_{0};
+};
+
+// ========== Message Building ========== //
+/**
+ * Growable, cache-line aligned byte buffer for encoding outbound messages
+ * (FIX, JSON). clear() keeps the capacity, so once a builder has grown to the
+ * largest message it sees, encoding further messages never allocates.
+ *
+ * Numbers are formatted with std::to_chars (no locale, no temporaries).
+ */
+class MessageBuilder {
+public:
+    explicit MessageBuilder(std::size_t initialCapacity = 1024) { reserve(initialCapacity); }
+
+    MessageBuilder(const MessageBuilder&) = delete;
+    MessageBuilder& operator=(const MessageBuilder&) = delete;
+
+    ~MessageBuilder() {
+        if (data_) AlignedAllocator<char>().deallocate(data_, capacity_);
+    }
+
+    MessageBuilder& append(std::string_view s) {
+        char* p = grow(s.size());
+        std::memcpy(p, s.data(), s.size());
+        return *this;
+    }
+
+    MessageBuilder& append(char c) {
+        *grow(1) = c;
+        return *this;
+    }
+
+    /**
+     * Appends the decimal form of an integer or floating-point value.
+     */
+    template<typename Number>
+        requires std::is_arithmetic_v<Number>
+    MessageBuilder& appendNumber(Number value) {
+        constexpr std::size_t kMaxChars = 32;
+        reserve(size_ + kMaxChars);
+        const auto result = std::to_chars(data_ + size_, data_ + capacity_, value);
+        size_ = static_cast<std::size_t>(result.ptr - data_);
+        return *this;
+    }
+
+    /**
+     * Appends a FIX field: `tag=value<SOH>`.
+     */
+    MessageBuilder& fixField(int tag, std::string_view value) {
+        appendNumber(tag).append('=').append(value);
+        return append(kSoh);
+    }
+
+    template<typename Number>
+        requires std::is_arithmetic_v<Number>
+    MessageBuilder& fixField(int tag, Number value) {
+        appendNumber(tag).append('=').appendNumber(value);
+        return append(kSoh);
+    }
+
+    /**
+     * Appends the FIX trailer `10=NNN<SOH>` (byte sum modulo 256 of everything so far).
+     */
+    MessageBuilder& fixChecksum() {
+        unsigned sum = 0;
+        for (std::size_t i = 0; i < size_; ++i) sum += static_cast<unsigned char>(data_[i]);
+        const unsigned checksum = sum % 256;
+        const char digits[3] = {static_cast<char>('0' + checksum / 100), static_cast<char>('0' + checksum / 10 % 10),
+                                static_cast<char>('0' + checksum % 10)};
+        return append("10=").append(std::string_view(digits, 3)).append(kSoh);
+    }
+
+    void reserve(std::size_t capacity) {
+        if (capacity <= capacity_) return;
+        capacity = std::max(capacity, capacity_ * 2);
+        char* grown = AlignedAllocator<char>().allocate(capacity);
+        if (data_) {
+            std::memcpy(grown, data_, size_);
+            AlignedAllocator<char>().deallocate(data_, capacity_);
+        }
+        data_ = grown;
+        capacity_ = capacity;
+    }
+
+    /**
+     * Starts the next message; the buffer is kept.
+     */
+    void clear() noexcept { size_ = 0; }
+
+    std::string_view view() const noexcept { return {data_, size_}; }
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    static constexpr char kSoh = '\x01';
+
+private:
+    char* grow(std::size_t bytes) {
+        reserve(size_ + bytes);
+        char* p = data_ + size_;
+        size_ += bytes;
+        return p;
+    }
+
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+/**
+ * Thread-safe pool of MessageBuilders recycled across messages. acquire()
+ * hands out a cleared builder that has kept whatever capacity earlier messages
+ * grew it to; the Lease returns it on destruction. Builders are created from an
+ * AlignedObjectPool, so the pool only allocates while warming up.
+ */
+class MessageBuilderPool {
+public:
+    class Lease {
+    public:
+        Lease(MessageBuilderPool& pool, MessageBuilder* builder) noexcept : pool_(&pool), builder_(builder) {}
+        Lease(Lease&& other) noexcept
+            : pool_(other.pool_), builder_(std::exchange(other.builder_, nullptr)) {}
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        ~Lease() {
+            if (builder_) pool_->release(builder_);
+        }
+
+        MessageBuilder& operator*() const noexcept { return *builder_; }
+        MessageBuilder* operator->() const noexcept { return builder_; }
+
+    private:
+        MessageBuilderPool* pool_;
+        MessageBuilder* builder_;
+    };
+
+    explicit MessageBuilderPool(std::size_t initialCapacity = 1024) : initialCapacity_(initialCapacity) {}
+
+    MessageBuilderPool(const MessageBuilderPool&) = delete;
+    MessageBuilderPool& operator=(const MessageBuilderPool&) = delete;
+
+    /**
+     * All leases must have been returned.
+     */
+    ~MessageBuilderPool() {
+        for (MessageBuilder* builder : free_) builders_.destroy(builder);
+    }
+
+    Lease acquire() {
+        std::lock_guard<SpinLock> lock(lock_);
+        if (!free_.empty()) {
+            MessageBuilder* builder = free_.back();
+            free_.pop_back();
+            return Lease(*this, builder);
+        }
+        free_.reserve(++created_);  // release() must never allocate
+        return Lease(*this, builders_.create(initialCapacity_));
+    }
+
+private:
+    void release(MessageBuilder* builder) noexcept {
+        builder->clear();
+        std::lock_guard<SpinLock> lock(lock_);
+        free_.push_back(builder);
+    }
+
+    std::size_t initialCapacity_;
+    std::size_t created_ = 0;
+    SpinLock lock_;
+    AlignedVector<MessageBuilder*> free_;
+    AlignedObjectPool<MessageBuilder> builders_{16};
+};
+
+// ========== Columnar Time Series ========== //
+/**
+ * Per-chunk zone map: lets range queries skip chunks (or answer them from the
+ * statistics alone) without touching the column data.
+ */
+struct ChunkStats {
+    std::size_t rows = 0;
+    long minTimestamp = std::numeric_limits<long>::max();
+    long maxTimestamp = std::numeric_limits<long>::min();
+    double minPrice = std::numeric_limits<double>::infinity();
+    double maxPrice = -std::numeric_limits<double>::infinity();
+    long long volume = 0;
+    double notional = 0.0;  // Sum of price * volume
+};
+
+/**
+ * Result of TimeSeriesStore::aggregate(); chunk counters show how much data the
+ * query actually read.
+ */
+struct RangeAggregate {
+    std::size_t trades = 0;
+    long long volume = 0;
+    double notional = 0.0;
+    double high = -std::numeric_limits<double>::infinity();
+    double low = std::numeric_limits<double>::infinity();
+
+    std::size_t chunksSkipped = 0;    // Outside the range per zone map
+    std::size_t chunksFromStats = 0;  // Fully inside; answered from ChunkStats
+    std::size_t chunksScanned = 0;    // Straddling the range; columns scanned
+
+    double vwap() const noexcept { return volume ? notional / static_cast<double>(volume) : 0.0; }
+};
+
+// Runtime ISA dispatch needs GCC/Clang target attributes on x86
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define ALIGNED_SERIES_X86_DISPATCH 1
+#endif
+
+/**
+ * Boundary-chunk scan kernels behind TimeSeriesStore::aggregate(): count,
+ * volume, notional and high/low of the rows whose timestamp is in [from, to).
+ *
+ * The AVX2 body tests four timestamps per compare and folds the mask into
+ * every accumulator without branches; notional is summed in four lanes, so its
+ * rounding can differ from the portable loop in the last bits. Picked once
+ * from the CPU feature bits (and only where long is 64-bit).
+ */
+namespace serieskernels {
+
+using Scan = void (*)(const long* ts, const double* px, const int* vol, std::size_t rows, long from, long to,
+                      RangeAggregate& result) noexcept;
+
+inline void scanPortable(const long* ts, const double* px, const int* vol, std::size_t rows, long from, long to,
+                         RangeAggregate& result) noexcept {
+    std::size_t trades = 0;
+    long long volume = 0;
+    double notional = 0.0;
+    double high = result.high;
+    double low = result.low;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const bool in = (ts[i] >= from) & (ts[i] < to);
+        trades += in;
+        volume += in ? vol[i] : 0;
+        notional += in ? px[i] * vol[i] : 0.0;
+        high = in && px[i] > high ? px[i] : high;
+        low = in && px[i] < low ? px[i] : low;
+    }
+    result.trades += trades;
+    result.volume += volume;
+    result.notional += notional;
+    result.high = high;
+    result.low = low;
+}
+
+#if defined(ALIGNED_SERIES_X86_DISPATCH)
+__attribute__((target("avx2"))) void scanAvx2(const long* ts, const double* px, const int* vol, std::size_t rows,
+                                              long from, long to, RangeAggregate& result) noexcept {
+    const __m256i fromV = _mm256_set1_epi64x(from);
+    const __m256i toV = _mm256_set1_epi64x(to);
+    __m256i trades = _mm256_setzero_si256();
+    __m256i volume = _mm256_setzero_si256();
+    __m256d notional = _mm256_setzero_pd();
+    __m256d high = _mm256_set1_pd(result.high);
+    __m256d low = _mm256_set1_pd(result.low);
+
+    std::size_t i = 0;
+    for (; i + 4 <= rows; i += 4) {
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ts + i));
+        const __m256i in = _mm256_andnot_si256(_mm256_cmpgt_epi64(fromV, t), _mm256_cmpgt_epi64(toV, t));  // !(from > t) & t < to
+        const __m256d inPd = _mm256_castsi256_pd(in);
+        const __m128i v32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vol + i));
+        const __m256d p = _mm256_loadu_pd(px + i);
+
+        trades = _mm256_sub_epi64(trades, in);  // Mask lanes are -1
+        volume = _mm256_add_epi64(volume, _mm256_and_si256(_mm256_cvtepi32_epi64(v32), in));
+        notional = _mm256_add_pd(notional, _mm256_and_pd(_mm256_mul_pd(p, _mm256_cvtepi32_pd(v32)), inPd));
+        high = _mm256_max_pd(high, _mm256_blendv_pd(high, p, inPd));
+        low = _mm256_min_pd(low, _mm256_blendv_pd(low, p, inPd));
+    }
+
+    alignas(32) long long tradeLanes[4], volumeLanes[4];
+    alignas(32) double notionalLanes[4], highLanes[4], lowLanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tradeLanes), trades);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(volumeLanes), volume);
+    _mm256_store_pd(notionalLanes, notional);
+    _mm256_store_pd(highLanes, high);
+    _mm256_store_pd(lowLanes, low);
+    for (int lane = 0; lane < 4; ++lane) {
+        result.trades += static_cast<std::size_t>(tradeLanes[lane]);
+        result.volume += volumeLanes[lane];
+        result.notional += notionalLanes[lane];
+        result.high = std::max(result.high, highLanes[lane]);
+        result.low = std::min(result.low, lowLanes[lane]);
+    }
+    scanPortable(ts + i, px + i, vol + i, rows - i, from, to, result);
+}
+#endif
+
+/**
+ * Best scan kernel for the running CPU, chosen once.
+ */
+inline Scan scanKernel() noexcept {
+    static const Scan selected = [] {
+#if defined(ALIGNED_SERIES_X86_DISPATCH)
+        __builtin_cpu_init();
+        if (sizeof(long) == 8 && __builtin_cpu_supports("avx2")) return &scanAvx2;
+#endif
+        return &scanPortable;
+    }();
+    return selected;
+}
+
+}  // namespace serieskernels
+
+/**
+ * Append-only columnar store for intraday trades: timestamp, price and volume
+ * each live in their own page-aligned, fixed-size column chunk, so a query
+ * reads only the columns it needs, and each chunk carries a ChunkStats zone map.
+ *
+ * Range queries classify every chunk by its timestamp bounds: disjoint chunks
+ * are skipped, contained chunks are answered from their statistics, and only the
+ * (usually two) boundary chunks are scanned, by a runtime-dispatched AVX2
+ * kernel (serieskernels) where the CPU has it. Timestamps need not be sorted; late prints only widen
+ * the zone maps.
+ *
+ * Sealed (full) chunks can be spilled to a file with spillSealed(): the column
+ * data is written out, mapped back read-only and the anonymous memory freed,
+ * leaving the page cache to decide what stays resident.
+ *
+ * @tparam ChunkRows Rows per chunk; a multiple of 1024 keeps every column chunk page-sized
+ */
+template<std::size_t ChunkRows = 8192>
+class TimeSeriesStore {
+    static_assert(ChunkRows % 1024 == 0, "ChunkRows must keep each column chunk a whole number of pages");
+
+    struct Chunk {
+        long* timestamps;
+        double* prices;
+        int* volumes;
+        ChunkStats stats;
+        bool spilled = false;
+    };
+
+    template<typename T>
+    using ColumnAllocator = AlignedAllocator<T, MEMORY_PAGE_SIZE>;
+
+public:
+    static constexpr std::size_t kChunkRows = ChunkRows;
+
+    TimeSeriesStore() = default;
+    TimeSeriesStore(const TimeSeriesStore&) = delete;
+    TimeSeriesStore& operator=(const TimeSeriesStore&) = delete;
+
+    ~TimeSeriesStore() {
+        for (Chunk& chunk : chunks_) {
+            if (!chunk.spilled) freeColumns(chunk);
+        }
+#if !defined(_WIN32)
+        for (const auto& [base, bytes] : mappings_) munmap(base, bytes);
+#endif
+    }
+
+    void append(long timestamp, double price, int volume) {
+        if (chunks_.empty() || chunks_.back().stats.rows == ChunkRows) addChunk();
+        Chunk& chunk = chunks_.back();
+        ChunkStats& s = chunk.stats;
+        chunk.timestamps[s.rows] = timestamp;
+        chunk.prices[s.rows] = price;
+        chunk.volumes[s.rows] = volume;
+        ++s.rows;
+        s.minTimestamp = std::min(s.minTimestamp, timestamp);
+        s.maxTimestamp = std::max(s.maxTimestamp, timestamp);
+        s.minPrice = std::min(s.minPrice, price);
+        s.maxPrice = std::max(s.maxPrice, price);
+        s.volume += volume;
+        s.notional += price * volume;
+        ++rows_;
+    }
+
+    std::size_t size() const noexcept { return rows_; }
+    std::size_t chunkCount() const noexcept { return chunks_.size(); }
+    const ChunkStats& chunkStats(std::size_t chunk) const noexcept { return chunks_[chunk].stats; }
+
+    /**
+     * Trades, volume, notional (VWAP) and high/low for timestamps in [from, to).
+     */
+    RangeAggregate aggregate(long from, long to) const noexcept {
+        RangeAggregate result;
+        for (const Chunk& chunk : chunks_) {
+            const ChunkStats& s = chunk.stats;
+            if (s.maxTimestamp < from || s.minTimestamp >= to) {
+                ++result.chunksSkipped;
+            } else if (s.minTimestamp >= from && s.maxTimestamp < to) {
+                ++result.chunksFromStats;
+                result.trades += s.rows;
+                result.volume += s.volume;
+                result.notional += s.notional;
+                result.high = std::max(result.high, s.maxPrice);
+                result.low = std::min(result.low, s.minPrice);
+            } else {
+                ++result.chunksScanned;
+                scanChunk(chunk, from, to, result);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Trades in [from, to) priced within [minPrice, maxPrice]; the price zone map
+     * prunes chunks as well as the timestamp one. Reads no volume data.
+     */
+    std::size_t countInRange(long from, long to, double minPrice, double maxPrice) const noexcept {
+        std::size_t count = 0;
+        for (const Chunk& chunk : chunks_) {
+            const ChunkStats& s = chunk.stats;
+            if (s.maxTimestamp < from || s.minTimestamp >= to || s.maxPrice < minPrice || s.minPrice > maxPrice) continue;
+            const long* ts = chunk.timestamps;
+            const double* px = chunk.prices;
+            for (std::size_t i = 0; i < s.rows; ++i) {
+                count += (ts[i] >= from) & (ts[i] < to) & (px[i] >= minPrice) & (px[i] <= maxPrice);
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Writes every full, still-resident chunk to the end of `path` and maps it
+     * back read-only, releasing the anonymous column memory.
+     * @return number of chunks spilled; 0 (nothing changed) on I/O failure or Windows
+     */
+    std::size_t spillSealed(const std::string& path) {
+#if defined(_WIN32)
+        (void)path;
+        return 0;
+#else
+        std::vector<Chunk*> sealed;
+        for (Chunk& chunk : chunks_) {
+            if (!chunk.spilled && chunk.stats.rows == ChunkRows) sealed.push_back(&chunk);
+        }
+        if (sealed.empty()) return 0;
+
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return 0;
+        const off_t offset = ::lseek(fd, 0, SEEK_END);  // Always page-aligned: every batch is whole pages
+        const std::size_t bytes = sealed.size() * kChunkBytes;
+
+        bool ok = offset >= 0 && offset % static_cast<off_t>(MEMORY_PAGE_SIZE) == 0;
+        off_t at = offset;
+        for (std::size_t i = 0; ok && i < sealed.size(); ++i) {
+            ok = writeAll(fd, sealed[i]->timestamps, kTimestampBytes, at) &&
+                 writeAll(fd, sealed[i]->prices, kPriceBytes, at + kTimestampBytes) &&
+                 writeAll(fd, sealed[i]->volumes, kVolumeBytes, at + kTimestampBytes + kPriceBytes);
+            at += kChunkBytes;
+        }
+
+        void* mapped = ok ? mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, offset) : MAP_FAILED;
+        ::close(fd);
+        if (mapped == MAP_FAILED) return 0;
+        mappings_.push_back({mapped, bytes});
+
+        std::byte* base = static_cast<std::byte*>(mapped);
+        for (Chunk* chunk : sealed) {
+            freeColumns(*chunk);
+            chunk->timestamps = reinterpret_cast<long*>(base);
+            chunk->prices = reinterpret_cast<double*>(base + kTimestampBytes);
+            chunk->volumes = reinterpret_cast<int*>(base + kTimestampBytes + kPriceBytes);
+            chunk->spilled = true;
+            base += kChunkBytes;
+        }
+        return sealed.size();
+#endif
+    }
+
+private:
+    static constexpr std::size_t kTimestampBytes = ChunkRows * sizeof(long);
+    static constexpr std::size_t kPriceBytes = ChunkRows * sizeof(double);
+    static constexpr std::size_t kVolumeBytes = ChunkRows * sizeof(int);
+    static constexpr std::size_t kChunkBytes = kTimestampBytes + kPriceBytes + kVolumeBytes;
+
+    void addChunk() {
+        Chunk chunk{};
+        chunk.timestamps = ColumnAllocator<long>().allocate(ChunkRows);
+        chunk.prices = ColumnAllocator<double>().allocate(ChunkRows);
+        chunk.volumes = ColumnAllocator<int>().allocate(ChunkRows);
+        chunks_.push_back(chunk);
+    }
+
+    static void freeColumns(Chunk& chunk) noexcept {
+        ColumnAllocator<long>().deallocate(chunk.timestamps, ChunkRows);
+        ColumnAllocator<double>().deallocate(chunk.prices, ChunkRows);
+        ColumnAllocator<int>().deallocate(chunk.volumes, ChunkRows);
+    }
+
+    // Boundary chunk: one pass over the needed columns
+    static void scanChunk(const Chunk& chunk, long from, long to, RangeAggregate& result) noexcept {
+        serieskernels::scanKernel()(chunk.timestamps, chunk.prices, chunk.volumes, chunk.stats.rows, from, to, result);
+    }
+
+#if !defined(_WIN32)
+    static bool writeAll(int fd, const void* data, std::size_t bytes, off_t offset) noexcept {
+        const char* p = static_cast<const char*>(data);
+        while (bytes) {
+            const ssize_t n = ::pwrite(fd, p, bytes, offset);
+            if (n <= 0) return false;
+            p += n;
+            bytes -= static_cast<std::size_t>(n);
+            offset += n;
+        }
+        return true;
+    }
+#endif
+
+    AlignedVector<Chunk> chunks_;
+    std::size_t rows_ = 0;
+    std::vector<std::pair<void*, std::size_t>> mappings_;
+};
+
+// ========== Aligned Direct I/O ========== //
+// io_uring when the kernel header is available at build time; pread/pwrite otherwise
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+    #define ALIGNED_IO_URING 1
+#endif
+
+#if !defined(_WIN32)
+/**
+ * Fixed set of equally sized, page-aligned I/O buffers carved from a single
+ * AlignedVector<std::byte, MEMORY_PAGE_SIZE>. One allocation means the whole
+ * pool can be registered with io_uring once, so fixed reads/writes skip the
+ * per-request page pinning.
+ */
+class DirectIoBufferPool {
+public:
+    /**
+     * @param count Number of buffers
+     * @param bufferBytes Bytes per buffer, rounded up to a whole page (O_DIRECT granularity)
+     */
+    DirectIoBufferPool(unsigned count, std::size_t bufferBytes)
+        : bufferBytes_((bufferBytes + MEMORY_PAGE_SIZE - 1) & ~(MEMORY_PAGE_SIZE - 1)),
+          storage_(bufferBytes_ * count) {  // Value-initialised, so the pool is pre-faulted
+        free_.reserve(count);
+        for (unsigned i = count; i-- > 0;) free_.push_back(i);
+    }
+
+    unsigned count() const noexcept { return static_cast<unsigned>(storage_.size() / bufferBytes_); }
+    std::size_t bufferBytes() const noexcept { return bufferBytes_; }
+    std::size_t available() const noexcept { return free_.size(); }
+
+    std::span<std::byte> buffer(unsigned index) noexcept {
+        assert(index < count());
+        return {storage_.data() + std::size_t{index} * bufferBytes_, bufferBytes_};
+    }
+
+    std::optional<unsigned> acquire() {
+        if (free_.empty()) return std::nullopt;
+        const unsigned index = free_.back();
+        free_.pop_back();
+        return index;
+    }
+
+    void release(unsigned index) {
+        assert(index < count());
+        free_.push_back(index);
+    }
+
+private:
+    std::size_t bufferBytes_;
+    AlignedVector<std::byte, MEMORY_PAGE_SIZE> storage_;
+    std::vector<unsigned> free_;
+};
+
+/**
+ * RAII file descriptor opened with O_DIRECT where the filesystem allows it
+ * (tmpfs and some network filesystems reject it; those fall back to buffered
+ * I/O and direct() reports false).
+ *
+ * With O_DIRECT, buffer addresses, offsets and lengths must be multiples of
+ * kDirectAlignment; MEMORY_PAGE_SIZE covers both 512-byte and 4K-sector devices.
+ */
+class AlignedFile {
+public:
+    enum class Mode { Read, Write, ReadWrite };
+    static constexpr std::size_t kDirectAlignment = MEMORY_PAGE_SIZE;
+
+    AlignedFile() = default;
+    AlignedFile(const std::string& path, Mode mode, bool direct = true) { open(path, mode, direct); }
+    AlignedFile(const AlignedFile&) = delete;
+    AlignedFile& operator=(const AlignedFile&) = delete;
+    ~AlignedFile() { close(); }
+
+    bool open(const std::string& path, Mode mode, bool direct = true) {
+        close();
+        const int flags = mode == Mode::Read    ? O_RDONLY
+                          : mode == Mode::Write ? O_WRONLY | O_CREAT | O_TRUNC
+                                                : O_RDWR | O_CREAT;
+#if defined(O_DIRECT)
+        if (direct) {
+            fd_ = ::open(path.c_str(), flags | O_DIRECT | O_CLOEXEC, 0644);
+            direct_ = fd_ >= 0;
+            if (fd_ >= 0 || errno != EINVAL) return fd_ >= 0;
+        }
+#else
+        (void)direct;
+#endif
+        fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        return fd_ >= 0;
+    }
+
+    void close() noexcept {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        direct_ = false;
+    }
+
+    bool isOpen() const noexcept { return fd_ >= 0; }
+    bool direct() const noexcept { return direct_; }
+    int fd() const noexcept { return fd_; }
+
+    /** @return file size in bytes, or -1 on error */
+    off_t size() const noexcept { return ::lseek(fd_, 0, SEEK_END); }
+
+    bool truncate(off_t bytes) const noexcept { return ::ftruncate(fd_, bytes) == 0; }
+
+private:
+    int fd_ = -1;
+    bool direct_ = false;
+};
+
+/**
+ * Batched asynchronous reads and writes over io_uring, talking to the kernel
+ * through the raw syscalls (no liburing dependency).
+ *
+ * Requests are queued into the submission ring with queueRead()/queueWrite()
+ * (or the *Fixed variants, which use buffers of a DirectIoBufferPool
+ * registered once at construction) and handed to the kernel together by one
+ * submit(). poll() reaps finished requests straight from the shared completion
+ * ring without a syscall; wait() blocks for at least N completions.
+ *
+ * Where io_uring is unavailable - no <linux/io_uring.h> at build time, or
+ * io_uring_setup refused at run time (old kernel, seccomp) - the same interface
+ * runs the batch synchronously with pread/pwrite at submit().
+ */
+class AlignedIoRing {
+public:
+    struct Completion {
+        std::uint64_t tag;
+        int result;  // Bytes transferred, or -errno
+    };
+
+    /**
+     * @param depth Maximum requests queued plus in flight
+     * @param pool Optional buffer pool to register for the *Fixed operations
+     */
+    explicit AlignedIoRing(unsigned depth, DirectIoBufferPool* pool = nullptr) : depth_(depth), pool_(pool) {
+        assert(depth > 0);
+#if defined(ALIGNED_IO_URING)
+        setupRing();
+#endif
+        if (!usingIoUring()) fallback_.reserve(depth);
+    }
+
+    AlignedIoRing(const AlignedIoRing&) = delete;
+    AlignedIoRing& operator=(const AlignedIoRing&) = delete;
+
+    ~AlignedIoRing() {
+#if defined(ALIGNED_IO_URING)
+        if (ringFd_ >= 0) {
+            // Requests still in flight may target caller buffers; drain before tearing down
+            while (inFlight_ > 0 && wait(inFlight_, [](const Completion&) {}) > 0) {}
+            if (sqes_) munmap(sqes_, sqesBytes_);
+            if (cqRing_ && cqRing_ != sqRing_) munmap(cqRing_, cqRingBytes_);
+            if (sqRing_) munmap(sqRing_, sqRingBytes_);
+            ::close(ringFd_);
+        }
+#endif
+    }
+
+    bool usingIoUring() const noexcept { return ringFd_ >= 0; }
+    bool buffersRegistered() const noexcept { return registered_; }
+    unsigned pending() const noexcept { return queued_; }     // Queued, not yet submitted
+    unsigned inFlight() const noexcept { return inFlight_; }  // Submitted, not yet reaped
+
+    /** Read `bytes` at `offset` into `dst`. @return false if the ring is full */
+    bool queueRead(int fd, void* dst, unsigned bytes, off_t offset, std::uint64_t tag) {
+        return queue(Op::Read, fd, dst, bytes, offset, tag, -1);
+    }
+
+    /** Write `bytes` from `src` at `offset`. @return false if the ring is full */
+    bool queueWrite(int fd, const void* src, unsigned bytes, off_t offset, std::uint64_t tag) {
+        return queue(Op::Write, fd, const_cast<void*>(src), bytes, offset, tag, -1);
+    }
+
+    /** Read into pool buffer `index` (registered: no per-request page pinning) */
+    bool queueReadFixed(int fd, unsigned index, unsigned bytes, off_t offset, std::uint64_t tag) {
+        assert(pool_ && bytes <= pool_->bufferBytes());
+        return queue(Op::Read, fd, pool_->buffer(index).data(), bytes, offset, tag, static_cast<int>(index));
+    }
+
+    /** Write from pool buffer `index` */
+    bool queueWriteFixed(int fd, unsigned index, unsigned bytes, off_t offset, std::uint64_t tag) {
+        assert(pool_ && bytes <= pool_->bufferBytes());
+        return queue(Op::Write, fd, pool_->buffer(index).data(), bytes, offset, tag, static_cast<int>(index));
+    }
+
+    /**
+     * Hand every queued request to the kernel with a single syscall.
+     * @return number of requests submitted
+     */
+    unsigned submit() {
+        const unsigned count = queued_;
+        if (count == 0) return 0;
+#if defined(ALIGNED_IO_URING)
+        if (usingIoUring()) {
+            const long submitted = enter(count, 0, 0);
+            if (submitted <= 0) return 0;
+            queued_ -= static_cast<unsigned>(submitted);
+            inFlight_ += static_cast<unsigned>(submitted);
+            return static_cast<unsigned>(submitted);
+        }
+#endif
+        // fallback_ holds the executed, unreaped requests first, then the queued ones
+        for (std::size_t i = inFlight_; i < fallback_.size(); ++i) {
+            Request& r = fallback_[i];
+            const ssize_t n = r.op == Op::Read ? ::pread(r.fd, r.data, r.bytes, r.offset)
+                                               : ::pwrite(r.fd, r.data, r.bytes, r.offset);
+            r.result = n < 0 ? -errno : static_cast<int>(n);
+        }
+        queued_ = 0;
+        inFlight_ += count;
+        return count;
+    }
+
+    /**
+     * Reap completions already posted, without blocking or a syscall.
+     * @return number of completions passed to `onComplete`
+     */
+    template<typename F>
+    unsigned poll(F&& onComplete) {
+#if defined(ALIGNED_IO_URING)
+        if (usingIoUring()) {
+            unsigned head = *cqHead_;
+            const unsigned tail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+            unsigned reaped = 0;
+            for (; head != tail; ++head, ++reaped) {
+                const io_uring_cqe& cqe = cqes_[head & cqMask_];
+                onComplete(Completion{cqe.user_data, cqe.res});
+            }
+            std::atomic_ref<unsigned>(*cqHead_).store(head, std::memory_order_release);
+            inFlight_ -= reaped;
+            return reaped;
+        }
+#endif
+        // Only submitted requests are reaped; those queued after the last submit() stay queued
+        const unsigned reaped = inFlight_;
+        for (unsigned i = 0; i < reaped; ++i) onComplete(Completion{fallback_[i].tag, fallback_[i].result});
+        fallback_.erase(fallback_.begin(), fallback_.begin() + reaped);
+        inFlight_ = 0;
+        return reaped;
+    }
+
+    /**
+     * Block until at least `minComplete` submitted requests have finished, then reap.
+     * @return number of completions passed to `onComplete`
+     */
+    template<typename F>
+    unsigned wait(unsigned minComplete, F&& onComplete) {
+        minComplete = std::min(minComplete, inFlight_);
+        unsigned reaped = poll(onComplete);
+#if defined(ALIGNED_IO_URING)
+        while (usingIoUring() && reaped < minComplete) {
+            if (enter(0, minComplete - reaped, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) break;
+            reaped += poll(onComplete);
+        }
+#endif
+        return reaped;
+    }
+
+private:
+    enum class Op : std::uint8_t { Read, Write };
+
+    struct Request {
+        Op op;
+        int fd;
+        void* data;
+        unsigned bytes;
+        off_t offset;
+        std::uint64_t tag;
+        int result;
+    };
+
+    bool queue(Op op, int fd, void* data, unsigned bytes, off_t offset, std::uint64_t tag, int fixedIndex) {
+        if (inFlight_ + queued_ == depth_) return false;
+#if defined(ALIGNED_IO_URING)
+        if (usingIoUring()) {
+            const unsigned tail = *sqTail_;
+            if (tail - std::atomic_ref<unsigned>(*sqHead_).load(std::memory_order_acquire) == sqEntries_) return false;
+            const unsigned slot = tail & sqMask_;
+            io_uring_sqe& sqe = sqes_[slot];
+            std::memset(&sqe, 0, sizeof(sqe));
+            const bool fixed = fixedIndex >= 0 && registered_;
+            sqe.opcode = op == Op::Read ? (fixed ? IORING_OP_READ_FIXED : IORING_OP_READ)
+                                        : (fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE);
+            sqe.fd = fd;
+            sqe.off = static_cast<std::uint64_t>(offset);
+            sqe.addr = reinterpret_cast<std::uint64_t>(data);
+            sqe.len = bytes;
+            if (fixed) sqe.buf_index = static_cast<std::uint16_t>(fixedIndex);
+            sqe.user_data = tag;
+            sqArray_[slot] = slot;
+            std::atomic_ref<unsigned>(*sqTail_).store(tail + 1, std::memory_order_release);
+            ++queued_;
+            return true;
+        }
+#else
+        (void)fixedIndex;
+#endif
+        fallback_.push_back(Request{op, fd, data, bytes, offset, tag, 0});
+        ++queued_;
+        return true;
+    }
+
+#if defined(ALIGNED_IO_URING)
+    long enter(unsigned toSubmit, unsigned minComplete, unsigned flags) noexcept {
+        return ::syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    void setupRing() {
+        io_uring_params params{};
+        const long fd = ::syscall(__NR_io_uring_setup, depth_, &params);
+        if (fd < 0) return;
+        ringFd_ = static_cast<int>(fd);
+
+        sqRingBytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sqRingBytes_ = cqRingBytes_ = std::max(sqRingBytes_, cqRingBytes_);
+
+        auto map = [&](std::size_t bytes, off_t offset) -> void* {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, offset);
+            return p == MAP_FAILED ? nullptr : p;
+        };
+        sqRing_ = map(sqRingBytes_, IORING_OFF_SQ_RING);
+        cqRing_ = single ? sqRing_ : map(cqRingBytes_, IORING_OFF_CQ_RING);
+        sqesBytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqesBytes_, IORING_OFF_SQES));
+        if (!sqRing_ || !cqRing_ || !sqes_) {
+            if (sqes_) munmap(sqes_, sqesBytes_);
+            if (cqRing_ && cqRing_ != sqRing_) munmap(cqRing_, cqRingBytes_);
+            if (sqRing_) munmap(sqRing_, sqRingBytes_);
+            sqes_ = nullptr;
+            sqRing_ = cqRing_ = nullptr;
+            ::close(ringFd_);
+            ringFd_ = -1;
+            return;
+        }
+
+        auto* sq = static_cast<std::byte*>(sqRing_);
+        auto* cq = static_cast<std::byte*>(cqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqEntries_ = params.sq_entries;
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // Pin the pool once; if RLIMIT_MEMLOCK refuses, *Fixed requests use plain READ/WRITE
+        if (pool_) {
+            std::vector<iovec> iovs(pool_->count());
+            for (unsigned i = 0; i < pool_->count(); ++i) iovs[i] = {pool_->buffer(i).data(), pool_->bufferBytes()};
+            registered_ = ::syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_BUFFERS, iovs.data(),
+                                    static_cast<unsigned>(iovs.size())) == 0;
+        }
+    }
+
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sqRingBytes_ = 0;
+    std::size_t cqRingBytes_ = 0;
+    std::size_t sqesBytes_ = 0;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+#endif
+
+    unsigned depth_;
+    DirectIoBufferPool* pool_;
+    int ringFd_ = -1;
+    bool registered_ = false;
+    unsigned queued_ = 0;
+    unsigned inFlight_ = 0;
+    std::vector<Request> fallback_;
+};
+
+/**
+ * Load a whole file into `out` with O_DIRECT reads issued `depth` at a time
+ * straight into the vector's storage: no page-cache copy, no bounce buffer.
+ * @return false if the file cannot be opened or a read fails
+ */
+inline bool loadFileDirect(const std::string& path, AlignedVector<std::byte, MEMORY_PAGE_SIZE>& out,
+                           std::size_t chunkBytes = std::size_t{1} << 20, unsigned depth = 8) {
+    AlignedFile file(path, AlignedFile::Mode::Read);
+    if (!file.isOpen()) return false;
+    const off_t size = file.size();
+    if (size < 0) return false;
+
+    // O_DIRECT reads whole blocks, so the tail request runs to the next block boundary
+    const std::size_t bytes = static_cast<std::size_t>(size);
+    const std::size_t padded = (bytes + AlignedFile::kDirectAlignment - 1) & ~(AlignedFile::kDirectAlignment - 1);
+    chunkBytes = std::max(chunkBytes & ~(AlignedFile::kDirectAlignment - 1), AlignedFile::kDirectAlignment);
+    out.resize(padded);
+
+    AlignedIoRing ring(depth);
+    std::size_t next = 0;
+    std::size_t loaded = 0;
+    bool ok = true;
+    auto onComplete = [&](const AlignedIoRing::Completion& c) {
+        const std::size_t expected = std::min(chunkBytes, bytes - static_cast<std::size_t>(c.tag));
+        if (c.result < 0 || static_cast<std::size_t>(c.result) < expected) ok = false;
+        else loaded += expected;
+    };
+    while (ok && (next < padded || ring.inFlight() > 0)) {
+        while (next < padded && ring.queueRead(file.fd(), out.data() + next,
+                                               static_cast<unsigned>(std::min(chunkBytes, padded - next)),
+                                               static_cast<off_t>(next), next)) {
+            next += chunkBytes;
+        }
+        ring.submit();
+        if (ring.pending() > 0 && ring.inFlight() == 0) return false;  // The kernel refused the batch
+        ring.wait(1, onComplete);
+    }
+    while (ring.inFlight() > 0 && ring.wait(ring.inFlight(), onComplete) > 0) {}
+
+    out.resize(bytes);
+    return ok && loaded == bytes;
+}
+
+/**
+ * Write `data` (page-aligned, e.g. from an AlignedVector<std::byte, MEMORY_PAGE_SIZE>)
+ * to `path` with O_DIRECT. The final partial block goes through a one-page
+ * aligned bounce buffer and the file is then trimmed to the exact size.
+ * @return false if the file cannot be created or a write fails
+ */
+inline bool storeFileDirect(const std::string& path, std::span<const std::byte> data,
+                            std::size_t chunkBytes = std::size_t{1} << 20, unsigned depth = 8) {
+    assert(reinterpret_cast<std::uintptr_t>(data.data()) % AlignedFile::kDirectAlignment == 0);
+    AlignedFile file(path, AlignedFile::Mode::Write);
+    if (!file.isOpen()) return false;
+
+    const std::size_t whole = data.size() & ~(AlignedFile::kDirectAlignment - 1);
+    const std::size_t tail = data.size() - whole;
+    chunkBytes = std::max(chunkBytes & ~(AlignedFile::kDirectAlignment - 1), AlignedFile::kDirectAlignment);
+    AlignedVector<std::byte, MEMORY_PAGE_SIZE> bounce(tail ? AlignedFile::kDirectAlignment : 0);
+    if (tail) std::memcpy(bounce.data(), data.data() + whole, tail);
+
+    AlignedIoRing ring(depth);
+    std::size_t next = 0;
+    bool tailQueued = tail == 0;
+    bool ok = true;
+    auto onComplete = [&](const AlignedIoRing::Completion& c) {
+        const std::size_t expected = c.tag == whole ? bounce.size() : std::min(chunkBytes, whole - c.tag);
+        if (c.result < 0 || static_cast<std::size_t>(c.result) != expected) ok = false;
+    };
+    while (ok && (next < whole || !tailQueued || ring.inFlight() > 0)) {
+        while (next < whole && ring.queueWrite(file.fd(), data.data() + next,
+                                               static_cast<unsigned>(std::min(chunkBytes, whole - next)),
+                                               static_cast<off_t>(next), next)) {
+            next += chunkBytes;
+        }
+        if (next >= whole && !tailQueued) {
+            tailQueued = ring.queueWrite(file.fd(), bounce.data(), static_cast<unsigned>(bounce.size()),
+                                         static_cast<off_t>(whole), whole);
+        }
+        ring.submit();
+        if (ring.pending() > 0 && ring.inFlight() == 0) return false;
+        ring.wait(1, onComplete);
+    }
+    while (ring.inFlight() > 0 && ring.wait(ring.inFlight(), onComplete) > 0) {}
+
+    return ok && (tail == 0 || file.truncate(static_cast<off_t>(data.size())));
+}
+#endif
+
+// ========== Event Journal ========== //
+#if !defined(_WIN32)
+/**
+ * On-disk record header. Records start on kRecordAlignment boundaries inside a
+ * segment; the payload follows the header directly.
+ */
+struct JournalRecordHeader {
+    std::uint32_t size;        // Header + payload bytes; 0 marks the end of a segment's records
+    std::uint16_t type;
+    std::uint16_t producer;    // Staging slot that recorded it
+    std::uint64_t sequence;    // Journal-wide, assigned at commit
+    std::int64_t timestampNs;  // Wall clock, taken on the recording thread
+};
+static_assert(sizeof(JournalRecordHeader) == 24);
+
+/** A record seen during EventJournal::replay(); points into the mapped segment. */
+struct JournalRecordView {
+    const JournalRecordHeader* header;
+    std::span<const std::byte> payload;
+
+    template<typename T>
+    T as() const noexcept {
+        static_assert(std::is_trivially_copyable_v<T>);
+        assert(payload.size() >= sizeof(T));
+        T value;
+        std::memcpy(&value, payload.data(), sizeof(T));
+        return value;
+    }
+};
+
+/**
+ * Append-only event journal with group commit.
+ *
+ * Each recording thread holds a Producer, which owns a page-aligned staging
+ * ring with head and tail on separate cache lines. Producer::record() copies
+ * header + payload into that ring and publishes the tail: no lock, no shared
+ * counter, no allocation, no syscall. A full ring drops the record and counts it.
+ *
+ * flush() - called by the background flusher or by hand - drains every ring
+ * into the current memory-mapped segment, assigning journal-wide sequence
+ * numbers, then makes the whole batch durable with one msync (group commit).
+ * Segments are fixed-size files (`<base>.000000.journal`, ...) that are
+ * allocated and pre-faulted one ahead, so rolling over never stalls a flush on
+ * page faults.
+ *
+ * replay() maps the segments read-only and walks the records in place.
+ * Creating a journal replaces any journal previously written at the same base path.
+ */
+class EventJournal {
+    struct StagingRing;
+
+public:
+    static constexpr std::size_t kRecordAlignment = 64;
+    static constexpr std::size_t kMaxProducers = 64;
+    static constexpr std::uint16_t kPaddingType = 0xFFFF;  // Skips the end of a staging ring; never journaled
+
+    /**
+     * @param basePath Segment file prefix
+     * @param segmentBytes Bytes per segment file (rounded up to whole pages)
+     * @param stagingBytes Bytes per producer staging ring (rounded up to a power of two, then capped
+     *        so the largest record it accepts fits in an empty segment)
+     * @param syncOnCommit msync each group commit; otherwise durability is left to writeback
+     * @throws std::runtime_error if the first segments cannot be created
+     */
+    explicit EventJournal(std::string basePath, std::size_t segmentBytes = std::size_t{64} << 20,
+                          std::size_t stagingBytes = std::size_t{64} << 10, bool syncOnCommit = true)
+        : basePath_(std::move(basePath)),
+          segmentBytes_((std::max(segmentBytes, 2 * MEMORY_PAGE_SIZE) + MEMORY_PAGE_SIZE - 1) & ~(MEMORY_PAGE_SIZE - 1)),
+          stagingBytes_(std::min(std::bit_ceil(std::max(stagingBytes, 4 * kRecordAlignment)),
+                                 std::bit_floor(4 * (segmentBytes_ - kSegmentHeaderBytes)))),
+          syncOnCommit_(syncOnCommit),
+          journalId_(static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())) {
+        if (!prepare(current_, 0) || !prepare(next_, 1)) {
+            release(current_, false);
+            release(next_, true);
+            throw std::runtime_error("EventJournal: cannot create segment files");
+        }
+        activate(current_);
+    }
+
+    EventJournal(const EventJournal&) = delete;
+    EventJournal& operator=(const EventJournal&) = delete;
+
+    ~EventJournal() {
+        stopFlusher();
+        flush();
+        release(current_, false);
+        release(next_, true);  // Pre-allocated but never used
+        for (auto& ring : rings_) delete ring.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Per-thread recording handle; claims one staging ring for its lifetime.
+     */
+    class Producer {
+    public:
+        explicit Producer(EventJournal& journal) : ring_(journal.acquireRing()) {}
+        ~Producer() { ring_->claimed.store(false, std::memory_order_release); }
+
+        Producer(const Producer&) = delete;
+        Producer& operator=(const Producer&) = delete;
+
+        /**
+         * Stages one record. Payloads up to a quarter of the staging ring are accepted.
+         * @return false (record dropped and counted) if the ring is full
+         */
+        bool record(std::uint16_t type, const void* payload, std::size_t bytes) noexcept {
+            assert(type != kPaddingType);
+            StagingRing& ring = *ring_;
+            const std::size_t size = sizeof(JournalRecordHeader) + bytes;
+            const std::size_t padded = roundUp(size);
+            const std::size_t capacity = ring.data.size();
+            if (padded > capacity / 4) {
+                ++ring.dropped;
+                return false;
+            }
+
+            std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+            const std::size_t offset = tail & (capacity - 1);
+            const std::size_t skip = capacity - offset < padded ? capacity - offset : 0;  // Records never wrap
+            if (tail + skip + padded - ring.headCache > capacity) {
+                ring.headCache = ring.head.load(std::memory_order_acquire);
+                if (tail + skip + padded - ring.headCache > capacity) {
+                    ++ring.dropped;
+                    return false;
+                }
+            }
+            if (skip) {
+                const JournalRecordHeader pad{static_cast<std::uint32_t>(skip), kPaddingType, ring.id, 0, 0};
+                std::memcpy(ring.data.data() + offset, &pad, sizeof(pad));
+                tail += skip;
+            }
+
+            std::byte* dst = ring.data.data() + (tail & (capacity - 1));
+            const JournalRecordHeader header{static_cast<std::uint32_t>(size), type, ring.id, 0, wallClockNs()};
+            std::memcpy(dst, &header, sizeof(header));
+            std::memcpy(dst + sizeof(header), payload, bytes);
+            ring.tail.store(tail + padded, std::memory_order_release);
+            return true;
+        }
+
+        template<typename T>
+        bool record(std::uint16_t type, const T& payload) noexcept {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return record(type, &payload, sizeof(T));
+        }
+
+        std::uint64_t dropped() const noexcept { return ring_->dropped; }
+
+    private:
+        StagingRing* ring_;
+    };
+
+    /**
+     * Group commit: drains every staging ring into the mapped segment and syncs once.
+     * Safe to call from any thread; concurrent calls serialize.
+     * @return number of records committed
+     */
+    std::size_t flush() {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        std::size_t committed = 0;
+        std::size_t dirtyBegin = writeOffset_;
+        for (auto& slot : rings_) {
+            StagingRing* ring = slot.load(std::memory_order_acquire);
+            if (!ring) continue;
+            const std::size_t mask = ring->data.size() - 1;
+            std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+            const std::uint64_t tail = ring->tail.load(std::memory_order_acquire);
+            while (head != tail) {
+                const std::byte* src = ring->data.data() + (head & mask);
+                JournalRecordHeader header;
+                std::memcpy(&header, src, sizeof(header));
+                if (header.type == kPaddingType) {
+                    head += header.size;
+                    continue;
+                }
+                const std::size_t padded = roundUp(header.size);
+                if (writeOffset_ + padded > segmentBytes_) {
+                    sync(dirtyBegin, writeOffset_);
+                    if (!roll()) break;  // Left staged; retried on the next flush
+                    dirtyBegin = writeOffset_;
+                    // The constructor's staging cap keeps every record within an empty segment
+                    if (writeOffset_ + padded > segmentBytes_) {
+                        assert(false && "journal record larger than a segment");
+                        head += padded;
+                        continue;
+                    }
+                }
+                std::byte* dst = current_.base + writeOffset_;
+                header.sequence = nextSequence_++;
+                std::memcpy(dst + sizeof(header), src + sizeof(header), header.size - sizeof(header));
+                std::memcpy(dst, &header, sizeof(header));
+                writeOffset_ += padded;
+                head += padded;
+                ++committed;
+            }
+            ring->head.store(head, std::memory_order_release);
+        }
+        sync(dirtyBegin, writeOffset_);
+        committedSequence_.store(nextSequence_, std::memory_order_release);
+        return committed;
+    }
+
+    /** Records with a sequence below this value are committed (durable with syncOnCommit). */
+    std::uint64_t committedSequence() const noexcept { return committedSequence_.load(std::memory_order_acquire); }
+
+    /**
+     * Starts a thread that flushes continuously, sleeping `idle` whenever a flush finds nothing.
+     */
+    void startFlusher(std::chrono::microseconds idle = std::chrono::microseconds(100)) {
+        if (flusher_.joinable()) return;
+        flusherRunning_.store(true, std::memory_order_relaxed);
+        flusher_ = std::thread([this, idle] {
+            while (flusherRunning_.load(std::memory_order_relaxed)) {
+                if (flush() == 0) std::this_thread::sleep_for(idle);
+            }
+        });
+    }
+
+    void stopFlusher() {
+        flusherRunning_.store(false, std::memory_order_relaxed);
+        if (flusher_.joinable()) flusher_.join();
+    }
+
+    /**
+     * Walks every record of the journal at `basePath`, in commit order, straight
+     * from read-only mappings of the segment files.
+     * @return number of records replayed
+     */
+    template<typename F>
+    static std::size_t replay(const std::string& basePath, F&& onRecord) {
+        std::size_t count = 0;
+        std::uint64_t journalId = 0;
+        for (std::size_t index = 0;; ++index) {
+            const int fd = ::open(segmentPath(basePath, index).c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) break;
+            const off_t end = ::lseek(fd, 0, SEEK_END);
+            void* mapped = end >= static_cast<off_t>(sizeof(SegmentHeader))
+                               ? mmap(nullptr, static_cast<std::size_t>(end), PROT_READ, MAP_PRIVATE, fd, 0)
+                               : MAP_FAILED;
+            ::close(fd);
+            if (mapped == MAP_FAILED) break;
+
+            const std::size_t bytes = static_cast<std::size_t>(end);
+            const auto* base = static_cast<const std::byte*>(mapped);
+            SegmentHeader segment;
+            std::memcpy(&segment, base, sizeof(segment));
+            if (index == 0) journalId = segment.journalId;
+            // Stops at leftovers of an older journal, or the unused pre-allocated segment
+            const bool valid = segment.magic == kMagic && segment.journalId == journalId &&
+                               segment.index == index && segment.firstSequence == count;
+            std::size_t offset = kSegmentHeaderBytes;
+            while (valid && offset + sizeof(JournalRecordHeader) <= bytes) {
+                const auto* header = reinterpret_cast<const JournalRecordHeader*>(base + offset);
+                if (header->size < sizeof(JournalRecordHeader) || header->size > bytes - offset) break;
+                onRecord(JournalRecordView{header, {base + offset + sizeof(JournalRecordHeader),
+                                                    header->size - sizeof(JournalRecordHeader)}});
+                offset += roundUp(header->size);
+                ++count;
+            }
+            munmap(mapped, bytes);
+            if (!valid) break;
+        }
+        return count;
+    }
+
+    static std::string segmentPath(const std::string& basePath, std::size_t index) {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), ".%06zu.journal", index);
+        return basePath + suffix;
+    }
+
+private:
+    static constexpr std::uint64_t kMagic = 0x314C4E524A414141ULL;  // "AAAJRNL1"
+    static constexpr std::size_t kSegmentHeaderBytes = kRecordAlignment;
+
+    struct SegmentHeader {
+        std::uint64_t magic;
+        std::uint64_t journalId;
+        std::uint64_t index;
+        std::uint64_t firstSequence;  // Set when the segment becomes current
+        std::uint32_t recordAlignment;
+    };
+    static_assert(sizeof(SegmentHeader) <= kSegmentHeaderBytes);
+
+    struct alignas(CACHE_LINE_SIZE) StagingRing {
+        explicit StagingRing(std::size_t bytes, std::uint16_t slot) : data(bytes), id(slot) {}  // Pre-faulted
+
+        AlignedVector<std::byte, MEMORY_PAGE_SIZE> data;
+        std::uint16_t id;
+        std::atomic<bool> claimed{false};
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail{0};  // Producer side
+        std::uint64_t headCache = 0;
+        std::uint64_t dropped = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head{0};  // Flusher side
+    };
+
+    struct Segment {
+        int fd = -1;
+        std::byte* base = nullptr;
+        std::size_t index = 0;
+    };
+
+    static constexpr std::size_t roundUp(std::size_t bytes) noexcept {
+        return (bytes + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+    }
+
+    static std::int64_t wallClockNs() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    StagingRing* acquireRing() {
+        std::lock_guard<std::mutex> lock(attachMutex_);
+        for (std::size_t i = 0; i < kMaxProducers; ++i) {
+            StagingRing* ring = rings_[i].load(std::memory_order_relaxed);
+            if (!ring) {
+                ring = new StagingRing(stagingBytes_, static_cast<std::uint16_t>(i));
+                ring->claimed.store(true, std::memory_order_relaxed);
+                rings_[i].store(ring, std::memory_order_release);
+                return ring;
+            }
+            bool expected = false;
+            if (ring->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) return ring;
+        }
+        throw std::runtime_error("EventJournal: producer slots exhausted");
+    }
+
+    // Sized, allocated and written through once, so the flush path takes no page faults
+    bool prepare(Segment& segment, std::size_t index) {
+        const std::string path = segmentPath(basePath_, index);
+        segment.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (segment.fd < 0) return false;
+        segment.index = index;
+#if defined(__linux__)
+        bool sized = ::posix_fallocate(segment.fd, 0, static_cast<off_t>(segmentBytes_)) == 0;
+#else
+        bool sized = false;
+#endif
+        if (!sized) sized = ::ftruncate(segment.fd, static_cast<off_t>(segmentBytes_)) == 0;
+        void* mapped = sized ? mmap(nullptr, segmentBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0)
+                             : MAP_FAILED;
+        if (mapped == MAP_FAILED) return false;
+        segment.base = static_cast<std::byte*>(mapped);
+        for (std::size_t page = 0; page < segmentBytes_; page += MEMORY_PAGE_SIZE) {
+            reinterpret_cast<volatile std::byte*>(segment.base)[page] = std::byte{0};
+        }
+        const SegmentHeader header{kMagic, journalId_, index, 0, static_cast<std::uint32_t>(kRecordAlignment)};
+        std::memcpy(segment.base, &header, sizeof(header));
+        return true;
+    }
+
+    void activate(Segment& segment) noexcept {
+        std::memcpy(segment.base + offsetof(SegmentHeader, firstSequence), &nextSequence_, sizeof(nextSequence_));
+        writeOffset_ = kSegmentHeaderBytes;
+    }
+
+    bool roll() {
+        if (!next_.base && !prepare(next_, current_.index + 1)) {
+            release(next_, true);
+            return false;
+        }
+        release(current_, false);
+        current_ = next_;
+        next_ = Segment{};
+        activate(current_);
+        if (!prepare(next_, current_.index + 1)) release(next_, true);  // Retried at the next roll
+        return true;
+    }
+
+    void release(Segment& segment, bool removeFile) noexcept {
+        if (segment.base) munmap(segment.base, segmentBytes_);
+        if (segment.fd >= 0) {
+            ::close(segment.fd);
+            if (removeFile) ::unlink(segmentPath(basePath_, segment.index).c_str());
+        }
+        segment = Segment{};
+    }
+
+    void sync(std::size_t begin, std::size_t end) noexcept {
+        if (!syncOnCommit_ || begin == end) return;
+        const std::size_t pageBegin = begin & ~(MEMORY_PAGE_SIZE - 1);
+        msync(current_.base + pageBegin, end - pageBegin, MS_SYNC);
+    }
+
+    std::string basePath_;
+    std::size_t segmentBytes_;
+    std::size_t stagingBytes_;
+    bool syncOnCommit_;
+    std::uint64_t journalId_;
+
+    std::array<std::atomic<StagingRing*>, kMaxProducers> rings_{};
+    std::mutex attachMutex_;
+
+    std::mutex flushMutex_;  // Guards everything below
+    Segment current_;
+    Segment next_;
+    std::size_t writeOffset_ = 0;
+    std::uint64_t nextSequence_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> committedSequence_{0};
+
+    std::thread flusher_;
+    std::atomic<bool> flusherRunning_{false};
+};
+#endif
+
+// ========== Snapshot / Restore ========== //
+#if !defined(_WIN32)
+/**
+ * Manifest entry: one block per container, page-aligned in the file so that a
+ * mapping (or one aligned read) of the file yields correctly aligned elements.
+ */
+struct SnapshotBlockInfo {
+    enum Kind : std::uint32_t { Array = 1, KeyValue = 2 };
+
+    char name[36];
+    std::uint32_t kind;
+    std::uint32_t elementSize;       // sizeof(element), checked on restore
+    std::uint32_t elementAlign;      // alignof(element), checked on restore
+    std::uint32_t keySize;           // sizeof(Key) for KeyValue blocks, checked on restore
+    std::uint32_t containerAlign;    // Alignment of the source container
+    std::uint64_t count;
+    std::uint64_t offset;            // Page-aligned file offset
+    std::uint64_t bytes;
+};
+static_assert(sizeof(SnapshotBlockInfo) == 80);
+
+/** Element layout of KeyValue blocks. */
+template<typename Key, typename T>
+struct SnapshotEntry {
+    Key key;
+    T value;
+};
+
+/**
+ * Writes trivially-copyable aligned containers into one snapshot file: a
+ * 32-byte header, the manifest, then each container as a raw page-aligned block.
+ *
+ * Vectors are written straight from their storage (keep them alive until
+ * commit()); hash maps are flattened into SnapshotEntry blocks first, since
+ * node-based containers have no contiguous image. commit() writes to
+ * `<path>.tmp`, fsyncs and renames, so a crash never leaves a torn snapshot.
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::string path) : path_(std::move(path)) {}
+
+    template<typename T, std::size_t Alignment>
+    void add(std::string_view name, const AlignedVector<T, Alignment>& vector) {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshots hold raw bytes");
+        Block block{describe<T>(name, SnapshotBlockInfo::Array, 0, Alignment, vector.size()), {}, nullptr};
+        block.data = reinterpret_cast<const std::byte*>(vector.data());
+        blocks_.push_back(std::move(block));
+    }
+
+    template<typename Key, typename T, std::size_t Alignment>
+    void add(std::string_view name, const AlignedUnorderedMap<Key, T, Alignment>& map) {
+        using Entry = SnapshotEntry<Key, T>;
+        static_assert(std::is_trivially_copyable_v<Entry>, "snapshots hold raw bytes");
+        Block block{describe<Entry>(name, SnapshotBlockInfo::KeyValue, sizeof(Key), Alignment, map.size()), {}, nullptr};
+        block.owned.resize(map.size() * sizeof(Entry));  // Zeroed, so struct padding is deterministic
+        auto* out = reinterpret_cast<Entry*>(block.owned.data());
+        for (const auto& [key, value] : map) {
+            out->key = key;
+            out->value = value;
+            ++out;
+        }
+        block.data = block.owned.data();
+        blocks_.push_back(std::move(block));
+    }
+
+    /**
+     * @return false if the file cannot be written; the previous snapshot at `path` is then untouched
+     */
+    bool commit() {
+        const std::size_t manifestEnd = sizeof(FileHeader) + blocks_.size() * sizeof(SnapshotBlockInfo);
+        std::uint64_t offset = roundToPage(manifestEnd);
+        std::vector<SnapshotBlockInfo> manifest;
+        manifest.reserve(blocks_.size());
+        for (Block& block : blocks_) {
+            block.info.offset = offset;
+            offset = roundToPage(offset + block.info.bytes);
+            manifest.push_back(block.info);
+        }
+
+        const std::string tmp = path_ + ".tmp";
+        const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        const FileHeader header{kSnapshotMagic, kSnapshotVersion, static_cast<std::uint32_t>(blocks_.size()), offset, 0};
+        bool ok = writeAt(fd, &header, sizeof(header), 0) &&
+                  writeAt(fd, manifest.data(), manifest.size() * sizeof(SnapshotBlockInfo), sizeof(header));
+        for (const Block& block : blocks_) {
+            ok = ok && writeAt(fd, block.data, block.info.bytes, static_cast<off_t>(block.info.offset));
+        }
+        // Pad to a whole page so the file can be read back in one O_DIRECT request
+        ok = ok && ::ftruncate(fd, static_cast<off_t>(offset)) == 0 && ::fsync(fd) == 0;
+        ::close(fd);
+        if (!ok || ::rename(tmp.c_str(), path_.c_str()) != 0) {
+            ::unlink(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    friend class SnapshotImage;
+
+    static constexpr std::uint64_t kSnapshotMagic = 0x3150414E53414141ULL;  // "AAASNAP1"
+    static constexpr std::uint32_t kSnapshotVersion = 1;
+
+    struct FileHeader {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t blockCount;
+        std::uint64_t fileBytes;
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(FileHeader) == 32);
+
+    struct Block {
+        SnapshotBlockInfo info;
+        AlignedVector<std::byte, MEMORY_PAGE_SIZE> owned;
+        const std::byte* data;
+    };
+
+    static constexpr std::uint64_t roundToPage(std::uint64_t bytes) noexcept {
+        return (bytes + MEMORY_PAGE_SIZE - 1) & ~std::uint64_t{MEMORY_PAGE_SIZE - 1};
+    }
+
+    template<typename Element>
+    static SnapshotBlockInfo describe(std::string_view name, std::uint32_t kind, std::size_t keySize,
+                                      std::size_t alignment, std::size_t count) {
+        SnapshotBlockInfo info{};
+        assert(name.size() < sizeof(info.name));
+        name.copy(info.name, sizeof(info.name) - 1);
+        info.kind = kind;
+        info.elementSize = sizeof(Element);
+        info.elementAlign = alignof(Element);
+        info.keySize = static_cast<std::uint32_t>(keySize);
+        info.containerAlign = static_cast<std::uint32_t>(alignment);
+        info.count = count;
+        info.bytes = count * sizeof(Element);
+        return info;
+    }
+
+    static bool writeAt(int fd, const void* data, std::size_t bytes, off_t offset) noexcept {
+        const char* p = static_cast<const char*>(data);
+        while (bytes) {
+            const ssize_t n = ::pwrite(fd, p, bytes, offset);
+            if (n <= 0) return false;
+            p += n;
+            bytes -= static_cast<std::size_t>(n);
+            offset += n;
+        }
+        return true;
+    }
+
+    std::string path_;
+    std::vector<Block> blocks_;
+};
+
+/**
+ * A loaded snapshot. Map mode mmaps the file (restore cost is page faults on
+ * first touch); Read mode pulls it into one page-aligned buffer with
+ * loadFileDirect (1 MiB O_DIRECT reads, up to 8 in flight). Either way blocks
+ * are page-aligned in memory.
+ *
+ * view() hands out a typed span straight over the image - no copy at all;
+ * restore() fills an aligned container from it (one memcpy for vectors, a
+ * pre-sized bulk insert for hash maps). Both check the manifest's element
+ * size and alignment and fail rather than reinterpret a mismatched block.
+ */
+class SnapshotImage {
+public:
+    enum class Load { Map, Read };
+
+    SnapshotImage() = default;
+    explicit SnapshotImage(const std::string& path, Load mode = Load::Map) { open(path, mode); }
+    SnapshotImage(const SnapshotImage&) = delete;
+    SnapshotImage& operator=(const SnapshotImage&) = delete;
+    ~SnapshotImage() { close(); }
+
+    bool open(const std::string& path, Load mode = Load::Map) {
+        close();
+        if (mode == Load::Read) {
+            if (!loadFileDirect(path, buffer_)) return false;
+            base_ = buffer_.data();
+            bytes_ = buffer_.size();
+        } else {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+            const off_t end = ::lseek(fd, 0, SEEK_END);
+            void* mapped = end > 0 ? mmap(nullptr, static_cast<std::size_t>(end), PROT_READ, MAP_PRIVATE, fd, 0)
+                                   : MAP_FAILED;
+            ::close(fd);
+            if (mapped == MAP_FAILED) return false;
+            base_ = static_cast<const std::byte*>(mapped);
+            bytes_ = static_cast<std::size_t>(end);
+            mapped_ = true;
+        }
+        if (!validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() noexcept {
+        if (mapped_) munmap(const_cast<std::byte*>(base_), bytes_);
+        buffer_.clear();
+        buffer_.shrink_to_fit();
+        base_ = nullptr;
+        bytes_ = 0;
+        mapped_ = false;
+        manifest_ = {};
+    }
+
+    bool isOpen() const noexcept { return base_ != nullptr; }
+    std::span<const SnapshotBlockInfo> blocks() const noexcept { return manifest_; }
+
+    const SnapshotBlockInfo* find(std::string_view name) const noexcept {
+        for (const SnapshotBlockInfo& info : manifest_) {
+            if (name == std::string_view(info.name, ::strnlen(info.name, sizeof(info.name)))) return &info;
+        }
+        return nullptr;
+    }
+
+    /** Zero-copy typed view of an Array block; empty if absent or the element layout differs. */
+    template<typename T>
+    std::span<const T> view(std::string_view name) const noexcept {
+        return typed<T>(name, SnapshotBlockInfo::Array, 0);
+    }
+
+    /** Zero-copy view of a KeyValue block. */
+    template<typename Key, typename T>
+    std::span<const SnapshotEntry<Key, T>> entries(std::string_view name) const noexcept {
+        return typed<SnapshotEntry<Key, T>>(name, SnapshotBlockInfo::KeyValue, sizeof(Key));
+    }
+
+    template<typename T, std::size_t Alignment>
+    bool restore(std::string_view name, AlignedVector<T, Alignment>& out) const {
+        const SnapshotBlockInfo* info = find(name);
+        if (!info || !matches<T>(*info, SnapshotBlockInfo::Array, 0)) return false;
+        const std::span<const T> items = view<T>(name);
+        out.assign(items.begin(), items.end());
+        return true;
+    }
+
+    template<typename Key, typename T, std::size_t Alignment>
+    bool restore(std::string_view name, AlignedUnorderedMap<Key, T, Alignment>& out) const {
+        const SnapshotBlockInfo* info = find(name);
+        if (!info || !matches<SnapshotEntry<Key, T>>(*info, SnapshotBlockInfo::KeyValue, sizeof(Key))) return false;
+        out.clear();
+        out.reserve(info->count);  // One bucket allocation, no rehash during the load
+        for (const auto& entry : entries<Key, T>(name)) out.emplace(entry.key, entry.value);
+        return true;
+    }
+
+private:
+    using FileHeader = SnapshotWriter::FileHeader;
+
+    template<typename Element>
+    static bool matches(const SnapshotBlockInfo& info, std::uint32_t kind, std::size_t keySize) noexcept {
+        static_assert(std::is_trivially_copyable_v<Element>, "snapshots hold raw bytes");
+        return info.kind == kind && info.elementSize == sizeof(Element) && info.elementAlign == alignof(Element) &&
+               info.keySize == keySize;
+    }
+
+    template<typename Element>
+    std::span<const Element> typed(std::string_view name, std::uint32_t kind, std::size_t keySize) const noexcept {
+        const SnapshotBlockInfo* info = find(name);
+        if (!info || !matches<Element>(*info, kind, keySize)) return {};
+        return {reinterpret_cast<const Element*>(base_ + info->offset), static_cast<std::size_t>(info->count)};
+    }
+
+    bool validate() {
+        if (bytes_ < sizeof(FileHeader)) return false;
+        FileHeader header;
+        std::memcpy(&header, base_, sizeof(header));
+        if (header.magic != SnapshotWriter::kSnapshotMagic || header.version != SnapshotWriter::kSnapshotVersion) {
+            return false;
+        }
+        if (sizeof(FileHeader) + std::size_t{header.blockCount} * sizeof(SnapshotBlockInfo) > bytes_) return false;
+        manifest_.resize(header.blockCount);
+        std::memcpy(manifest_.data(), base_ + sizeof(FileHeader), manifest_.size() * sizeof(SnapshotBlockInfo));
+        for (const SnapshotBlockInfo& info : manifest_) {
+            if (info.offset % MEMORY_PAGE_SIZE != 0 || info.offset > bytes_ || info.bytes > bytes_ - info.offset ||
+                info.bytes != info.count * info.elementSize) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    AlignedVector<std::byte, MEMORY_PAGE_SIZE> buffer_;
+    const std::byte* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    bool mapped_ = false;
+    std::vector<SnapshotBlockInfo> manifest_;
+};
+#endif
+
+// ========== Compressed Column Encodings ========== //
+// Runtime ISA dispatch needs GCC/Clang target attributes on x86
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define ALIGNED_PACKING_X86_DISPATCH 1
+#endif
+
+/**
+ * Bit-unpacking kernels behind PackedIntColumn / PackedPriceColumn.
+ *
+ * A block holds 1024 values bit-packed at a fixed width in 8 interleaved
+ * lanes: value i lives in lane i % 8, and word j of lane l is words[j * 8 + l].
+ * One 256-bit load therefore carries the next bits of eight consecutive
+ * values, so the AVX2 kernel decodes 8 values per shift/mask step with no
+ * cross-lane shuffles. Kernels are instantiated per width (0-32) so every
+ * shift is a constant, and write into 32-byte aligned output.
+ */
+namespace packkernels {
+
+inline constexpr unsigned kLanes = 8;
+inline constexpr unsigned kBlockValues = 1024;
+inline constexpr unsigned kLaneValues = kBlockValues / kLanes;
+
+constexpr std::size_t wordsForWidth(unsigned width) noexcept { return std::size_t{width} * kLaneValues / 32 * kLanes; }
+
+// `offsets` holds kBlockValues entries (zero-padded); `words` must be zeroed
+inline void pack(const std::uint32_t* offsets, unsigned width, std::uint32_t* words) noexcept {
+    for (unsigned lane = 0; lane < kLanes && width > 0; ++lane) {
+        unsigned bit = 0;
+        for (unsigned k = 0; k < kLaneValues; ++k, bit += width) {
+            const std::uint32_t v = offsets[k * kLanes + lane];
+            const unsigned word = bit / 32;
+            const unsigned shift = bit % 32;
+            words[word * kLanes + lane] |= v << shift;
+            if (shift + width > 32) words[(word + 1) * kLanes + lane] |= v >> (32 - shift);
+        }
+    }
+}
+
+template<unsigned Width>
+std::uint32_t laneValue(const std::uint32_t* words, unsigned lane, unsigned k) noexcept {
+    constexpr std::uint64_t mask = (std::uint64_t{1} << Width) - 1;
+    const unsigned bit = k * Width;
+    const unsigned word = bit / 32;
+    const unsigned shift = bit % 32;
+    std::uint64_t v = words[word * kLanes + lane] >> shift;
+    if (shift + Width > 32) v |= std::uint64_t{words[(word + 1) * kLanes + lane]} << (32 - shift);
+    return static_cast<std::uint32_t>(v & mask);
+}
+
+template<unsigned Width>
+void unpackPortable(const std::uint32_t* words, std::int64_t base, std::int64_t* out) noexcept {
+    for (unsigned i = 0; i < kBlockValues; ++i) {
+        out[i] = Width == 0 ? base : base + laneValue<Width>(words, i % kLanes, i / kLanes);
+    }
+}
+
+// Delta blocks: slot 0 holds no delta, so starting the running sum at (first - base) yields `first` there
+template<unsigned Width>
+void unpackDeltaPortable(const std::uint32_t* words, std::int64_t base, std::int64_t first, std::int64_t* out) noexcept {
+    unpackPortable<Width>(words, base, out);
+    std::uint64_t running = static_cast<std::uint64_t>(first) - static_cast<std::uint64_t>(base);
+    for (unsigned i = 0; i < kBlockValues; ++i) {
+        running += static_cast<std::uint64_t>(out[i]);
+        out[i] = static_cast<std::int64_t>(running);
+    }
+}
+
+template<unsigned Width>
+void unpackDoublePortable(const std::uint32_t* words, double base, double* out) noexcept {
+    for (unsigned i = 0; i < kBlockValues; ++i) {
+        out[i] = Width == 0 ? base : base + laneValue<Width>(words, i % kLanes, i / kLanes);
+    }
+}
+
+#if defined(ALIGNED_PACKING_X86_DISPATCH)
+// Offsets of the next eight values, one per lane. `more` is false on the last
+// step, where the lanes end exactly on a word boundary and nothing is loaded.
+template<unsigned Width>
+__attribute__((target("avx2"), always_inline)) inline __m256i unpackStep(const __m256i*& in, __m256i& current,
+                                                                         unsigned& shift, bool more) noexcept {
+    __m256i v = _mm256_srl_epi32(current, _mm_cvtsi32_si128(static_cast<int>(shift)));
+    shift += Width;
+    if (shift >= 32 && more) {
+        shift -= 32;
+        const __m256i next = _mm256_load_si256(in++);
+        if (shift > 0) v = _mm256_or_si256(v, _mm256_sll_epi32(next, _mm_cvtsi32_si128(static_cast<int>(Width - shift))));
+        current = next;
+    }
+    if constexpr (Width < 32) v = _mm256_and_si256(v, _mm256_set1_epi32(static_cast<int>((1u << Width) - 1)));
+    return v;
+}
+
+template<unsigned Width>
+__attribute__((target("avx2"))) void unpackAvx2(const std::uint32_t* words, std::int64_t base,
+                                                std::int64_t* out) noexcept {
+    const __m256i base64 = _mm256_set1_epi64x(base);
+    auto* dst = reinterpret_cast<__m256i*>(out);
+    if constexpr (Width == 0) {
+        for (unsigned i = 0; i < kBlockValues / 4; ++i) _mm256_store_si256(dst + i, base64);
+    } else {
+        const __m256i* in = reinterpret_cast<const __m256i*>(words);
+        __m256i current = _mm256_load_si256(in++);
+        unsigned shift = 0;
+        for (unsigned k = 0; k < kLaneValues; ++k) {
+            const __m256i v = unpackStep<Width>(in, current, shift, k + 1 < kLaneValues);
+            const __m256i lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v));
+            const __m256i hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1));
+            _mm256_store_si256(dst + 2 * k, _mm256_add_epi64(lo, base64));
+            _mm256_store_si256(dst + 2 * k + 1, _mm256_add_epi64(hi, base64));
+        }
+    }
+}
+
+// In-register prefix sum of four int64 lanes
+__attribute__((target("avx2"), always_inline)) inline __m256i prefixSum4(__m256i x) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    return _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+}
+
+// Stores four reconstructed values. Each group's local scan is independent;
+// only one add per four values sits on the carry chain.
+__attribute__((target("avx2"), always_inline)) inline void emitDeltas(__m256i* slot, __m256i deltas, __m256i base,
+                                                                      __m256i& carry) noexcept {
+    const __m256i local = prefixSum4(_mm256_add_epi64(deltas, base));
+    _mm256_store_si256(slot, _mm256_add_epi64(local, carry));
+    carry = _mm256_add_epi64(carry, _mm256_permute4x64_epi64(local, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+// Unpack fused with the delta prefix sum
+template<unsigned Width>
+__attribute__((target("avx2"))) void unpackDeltaAvx2(const std::uint32_t* words, std::int64_t base, std::int64_t first,
+                                                     std::int64_t* out) noexcept {
+    auto* dst = reinterpret_cast<__m256i*>(out);
+    const __m256i base64 = _mm256_set1_epi64x(base);
+    __m256i carry = _mm256_set1_epi64x(static_cast<std::int64_t>(static_cast<std::uint64_t>(first) -
+                                                                 static_cast<std::uint64_t>(base)));
+    if constexpr (Width == 0) {
+        for (unsigned i = 0; i < kBlockValues / 4; ++i) emitDeltas(dst + i, _mm256_setzero_si256(), base64, carry);
+    } else {
+        const __m256i* in = reinterpret_cast<const __m256i*>(words);
+        __m256i current = _mm256_load_si256(in++);
+        unsigned shift = 0;
+        for (unsigned k = 0; k < kLaneValues; ++k) {
+            const __m256i v = unpackStep<Width>(in, current, shift, k + 1 < kLaneValues);
+            emitDeltas(dst + 2 * k, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)), base64, carry);
+            emitDeltas(dst + 2 * k + 1, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)), base64, carry);
+        }
+    }
+}
+
+// Widths up to 31 only: offsets convert to double as signed 32-bit lanes
+template<unsigned Width>
+__attribute__((target("avx2"))) void unpackDoubleAvx2(const std::uint32_t* words, double base, double* out) noexcept {
+    const __m256d baseD = _mm256_set1_pd(base);
+    if constexpr (Width == 0) {
+        for (unsigned i = 0; i < kBlockValues; i += 4) _mm256_store_pd(out + i, baseD);
+    } else {
+        const __m256i* in = reinterpret_cast<const __m256i*>(words);
+        __m256i current = _mm256_load_si256(in++);
+        unsigned shift = 0;
+        for (unsigned k = 0; k < kLaneValues; ++k) {
+            const __m256i v = unpackStep<Width>(in, current, shift, k + 1 < kLaneValues);
+            _mm256_store_pd(out + 8 * k, _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), baseD));
+            _mm256_store_pd(out + 8 * k + 4, _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), baseD));
+        }
+    }
+}
+#endif
+
+struct Kernels {
+    using Unpack = void (*)(const std::uint32_t*, std::int64_t, std::int64_t*) noexcept;
+    using UnpackDelta = void (*)(const std::uint32_t*, std::int64_t, std::int64_t, std::int64_t*) noexcept;
+    using UnpackDouble = void (*)(const std::uint32_t*, double, double*) noexcept;
+
+    const char* name;
+    std::array<Unpack, 33> unpack;  // Indexed by bit width
+    std::array<UnpackDelta, 33> unpackDelta;
+    std::array<UnpackDouble, 32> unpackDouble;  // Widths 0-31
+};
+
+template<std::size_t... W>
+constexpr Kernels portableKernels(std::index_sequence<W...>) noexcept {
+    return Kernels{"portable", {&unpackPortable<W>..., &unpackPortable<32>},
+                   {&unpackDeltaPortable<W>..., &unpackDeltaPortable<32>}, {&unpackDoublePortable<W>...}};
+}
+
+#if defined(ALIGNED_PACKING_X86_DISPATCH)
+template<std::size_t... W>
+constexpr Kernels avx2Kernels(std::index_sequence<W...>) noexcept {
+    return Kernels{"avx2", {&unpackAvx2<W>..., &unpackAvx2<32>}, {&unpackDeltaAvx2<W>..., &unpackDeltaAvx2<32>},
+                   {&unpackDoubleAvx2<W>...}};
+}
+#endif
+
+/**
+ * Best kernels for the running CPU, chosen once.
+ */
+inline const Kernels& kernels() noexcept {
+    static const Kernels selected = [] {
+#if defined(ALIGNED_PACKING_X86_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return avx2Kernels(std::make_index_sequence<32>{});
+#endif
+        return portableKernels(std::make_index_sequence<32>{});
+    }();
+    return selected;
+}
+
+}  // namespace packkernels
+
+enum class ColumnEncoding : std::uint8_t {
+    FrameOfReference,  // Per block: min + bit-packed (value - min)
+    Delta              // Per block: first value + frame-of-reference packed deltas; for near-monotonic columns
+};
+
+/**
+ * Integer column compressed in blocks of 1024 values (see packkernels for the
+ * layout). Each block picks the narrowest width that fits its range, so a
+ * near-monotonic timestamp column (Delta) or a bounded volume column
+ * (FrameOfReference) typically packs to 4-16 bits per value. Blocks whose
+ * range needs more than 32 bits are stored raw.
+ *
+ * decodeBlock() writes a whole block into a caller-provided 32-byte aligned
+ * buffer of kBlockValues entries - small enough to stay in L1 while the
+ * caller aggregates it.
+ */
+class PackedIntColumn {
+public:
+    static constexpr std::size_t kBlockValues = packkernels::kBlockValues;
+
+    PackedIntColumn() = default;
+
+    template<std::integral I>
+    PackedIntColumn(std::span<const I> values, ColumnEncoding encoding) : encoding_(encoding), size_(values.size()) {
+        blocks_.reserve((values.size() + kBlockValues - 1) / kBlockValues);
+        AlignedVector<std::uint32_t> offsets(kBlockValues);
+        for (std::size_t begin = 0; begin < values.size(); begin += kBlockValues) {
+            const std::size_t count = std::min(kBlockValues, values.size() - begin);
+            appendBlock(values.subspan(begin, count), offsets);
+        }
+    }
+
+    ColumnEncoding encoding() const noexcept { return encoding_; }
+    std::size_t size() const noexcept { return size_; }
+    std::size_t blockCount() const noexcept { return blocks_.size(); }
+    std::size_t blockSize(std::size_t block) const noexcept { return blocks_[block].count; }
+    unsigned blockWidth(std::size_t block) const noexcept { return blocks_[block].width; }
+
+    /** Bytes of packed data plus block headers. */
+    std::size_t compressedBytes() const noexcept {
+        return words_.size() * sizeof(std::uint32_t) + blocks_.size() * sizeof(Block);
+    }
+
+    /**
+     * Decodes one block.
+     * @param out kBlockValues slots, 32-byte aligned
+     * @return number of valid values written
+     */
+    std::size_t decodeBlock(std::size_t block, std::int64_t* out) const noexcept {
+        assert(reinterpret_cast<std::uintptr_t>(out) % 32 == 0);
+        const Block& b = blocks_[block];
+        const std::uint32_t* words = words_.data() + b.wordOffset;
+        if (b.width == kRawWidth) {
+            std::memcpy(out, words, b.count * sizeof(std::int64_t));
+            return b.count;
+        }
+        if (encoding_ == ColumnEncoding::Delta) packkernels::kernels().unpackDelta[b.width](words, b.base, b.first, out);
+        else packkernels::kernels().unpack[b.width](words, b.base, out);
+        return b.count;
+    }
+
+    /**
+     * Frame-of-reference block decoded straight to double (int-to-double
+     * conversion fused into the unpack kernel). Exact below 2^53.
+     */
+    std::size_t decodeBlock(std::size_t block, double* out) const noexcept {
+        assert(encoding_ == ColumnEncoding::FrameOfReference);
+        assert(reinterpret_cast<std::uintptr_t>(out) % 32 == 0);
+        const Block& b = blocks_[block];
+        if (b.width < 32) {
+            packkernels::kernels().unpackDouble[b.width](words_.data() + b.wordOffset, static_cast<double>(b.base), out);
+        } else {
+            alignas(32) std::int64_t values[kBlockValues];
+            decodeBlock(block, values);
+            for (std::size_t i = 0; i < b.count; ++i) out[i] = static_cast<double>(values[i]);
+        }
+        return b.count;
+    }
+
+    /** Whole column, for tests and cold paths. */
+    void decode(AlignedVector<std::int64_t>& out) const {
+        out.resize(blocks_.size() * kBlockValues);
+        for (std::size_t block = 0; block < blocks_.size(); ++block) decodeBlock(block, out.data() + block * kBlockValues);
+        out.resize(size_);
+    }
+
+private:
+    static constexpr std::uint8_t kRawWidth = 64;
+
+    struct Block {
+        std::int64_t base;   // Minimum value (or delta)
+        std::int64_t first;  // Delta: first value of the block
+        std::uint32_t wordOffset;
+        std::uint16_t count;
+        std::uint8_t width;  // Bits per value, or kRawWidth
+    };
+
+    template<std::integral I>
+    void appendBlock(std::span<const I> values, AlignedVector<std::uint32_t>& offsets) {
+        const std::size_t count = values.size();
+        const bool delta = encoding_ == ColumnEncoding::Delta;
+        // Deltas in wrap-around arithmetic so extreme jumps cannot overflow
+        auto item = [&](std::size_t i) -> std::int64_t {
+            if (!delta) return static_cast<std::int64_t>(values[i]);
+            return static_cast<std::int64_t>(static_cast<std::uint64_t>(static_cast<std::int64_t>(values[i])) -
+                                             static_cast<std::uint64_t>(static_cast<std::int64_t>(values[i - 1])));
+        };
+
+        const std::size_t from = delta ? 1 : 0;
+        std::int64_t lo = count > from ? item(from) : 0;
+        std::int64_t hi = lo;
+        for (std::size_t i = from; i < count; ++i) {
+            lo = std::min(lo, item(i));
+            hi = std::max(hi, item(i));
+        }
+        const std::uint64_t range = static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo);
+
+        Block block{lo, delta ? static_cast<std::int64_t>(values[0]) : 0, static_cast<std::uint32_t>(words_.size()),
+                    static_cast<std::uint16_t>(count), static_cast<std::uint8_t>(std::bit_width(range))};
+        if (range > std::numeric_limits<std::uint32_t>::max()) {
+            block.width = kRawWidth;
+            words_.resize(words_.size() + roundWords(count * 2));
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::int64_t v = static_cast<std::int64_t>(values[i]);
+                std::memcpy(words_.data() + block.wordOffset + 2 * i, &v, sizeof(v));
+            }
+        } else {
+            std::fill(offsets.begin(), offsets.end(), 0u);
+            for (std::size_t i = from; i < count; ++i) {
+                offsets[i] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(item(i)) - static_cast<std::uint64_t>(lo));
+            }
+            words_.resize(words_.size() + packkernels::wordsForWidth(block.width));
+            packkernels::pack(offsets.data(), block.width, words_.data() + block.wordOffset);
+        }
+        blocks_.push_back(block);
+    }
+
+    // Keeps every block's words 32-byte aligned for the AVX2 loads
+    static constexpr std::size_t roundWords(std::size_t words) noexcept { return (words + 7) & ~std::size_t{7}; }
+
+    AlignedVector<Block> blocks_;
+    AlignedVector<std::uint32_t> words_;
+    ColumnEncoding encoding_ = ColumnEncoding::FrameOfReference;
+    std::size_t size_ = 0;
+};
+
+/**
+ * Price column on a tick grid: prices are stored as integer ticks
+ * (price * ticksPerUnit) with frame-of-reference packing, and decoded as
+ * ticks / ticksPerUnit - exact for any price that was on the grid.
+ */
+class PackedPriceColumn {
+public:
+    static constexpr std::size_t kBlockValues = PackedIntColumn::kBlockValues;
+
+    PackedPriceColumn() = default;
+
+    /**
+     * @throws std::invalid_argument if a price does not round-trip through the tick grid
+     */
+    PackedPriceColumn(std::span<const double> prices, std::int64_t ticksPerUnit)
+        : divisor_(static_cast<double>(ticksPerUnit)) {
+        AlignedVector<std::int64_t> ticks(prices.size());
+        for (std::size_t i = 0; i < prices.size(); ++i) {
+            ticks[i] = std::llround(prices[i] * divisor_);
+            if (static_cast<double>(ticks[i]) / divisor_ != prices[i]) {
+                throw std::invalid_argument("PackedPriceColumn: price is not on the tick grid");
+            }
+        }
+        ticks_ = PackedIntColumn(std::span<const std::int64_t>(ticks), ColumnEncoding::FrameOfReference);
+    }
+
+    std::size_t size() const noexcept { return ticks_.size(); }
+    std::size_t blockCount() const noexcept { return ticks_.blockCount(); }
+    std::size_t compressedBytes() const noexcept { return ticks_.compressedBytes(); }
+
+    double ticksPerUnit() const noexcept { return divisor_; }
+
+    /**
+     * Prices of one block.
+     * @param out kBlockValues slots, 32-byte aligned
+     */
+    std::size_t decodeBlock(std::size_t block, double* out) const noexcept {
+        const std::size_t count = ticks_.decodeBlock(block, out);
+        // Exact: division is correctly rounded. Fixed trip count so it vectorizes
+        for (std::size_t i = 0; i < kBlockValues; ++i) out[i] /= divisor_;
+        return count;
+    }
+
+    /**
+     * Prices of one block in ticks. Aggregations (notional, VWAP) can stay in
+     * ticks and divide by ticksPerUnit() once at the end.
+     */
+    std::size_t decodeTicks(std::size_t block, double* out) const noexcept { return ticks_.decodeBlock(block, out); }
+
+private:
+    PackedIntColumn ticks_;
+    double divisor_ = 1.0;
+};
+
+// ========== Example Usage ========== //
+struct TradeData {
+    alignas(CACHE_LINE_SIZE) std::atomic<int> volume;
+    double price;
+    long timestamp;
+};
+
+// Plain copyable view of a trade, used where a consistent multi-field snapshot is published
+struct TradeSnapshot {
+    int volume;
+    double price;
+    long timestamp;
+};
+
+// ========== Benchmarks ========== //
+// Compile with -DALIGNED_ALLOCATOR_BENCHMARKS (and -pthread -latomic) to run after the examples.
+#if defined(ALIGNED_ALLOCATOR_BENCHMARKS)
+#include <chrono>
+#include <cstdio>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+inline unsigned threadCount(unsigned wanted) {
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? wanted : std::min(wanted, hw * 2);
+}
+
+/**
+ * Runs one writer and `readers` reader threads against a publish/read pair for
+ * `durationMs` and prints reads and writes per second.
+ */
+template<typename Publish, typename Read>
+void runPublishBenchmark(const char* name, unsigned readers, int durationMs, Publish publish, Read read) {
+    std::atomic<bool> stop{false};
+    std::vector<CachePadded<std::uint64_t>> readCounts(readers);
+    std::uint64_t writes = 0;
+
+    std::vector<std::thread> threads;
+    for (unsigned r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            std::uint64_t n = 0;
+            long checksum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                checksum += read().timestamp;
+                ++n;
+            }
+            readCounts[r].value = n + (checksum == -1);  // Keep the reads observable
+        });
+    }
+
+    const auto start = Clock::now();
+    while (elapsedNs(start) < durationMs * 1e6) {
+        for (int i = 0; i < 64; ++i, ++writes) {
+            publish(TradeSnapshot{static_cast<int>(writes), 100.0 + writes, static_cast<long>(writes)});
+        }
+    }
+    stop = true;
+    for (auto& t : threads) t.join();
+
+    std::uint64_t reads = 0;
+    for (const auto& c : readCounts) reads += c.value;
+    const double seconds = durationMs / 1e3;
+    std::printf("%-28s readers=%-2u reads/s=%12.0f writes/s=%12.0f\n",
+                name, readers, reads / seconds, writes / seconds);
+}
+
+inline void seqLockVsMutexVsAtomic() {
+    const unsigned readers = threadCount(4);
+
+    SnapshotCell<TradeSnapshot> cell;
+    runPublishBenchmark("AlignedSeqLock", readers, 200,
+        [&](const TradeSnapshot& t) { cell.store(t); },
+        [&] { return cell.load(); });
+
+    std::mutex mutex;
+    TradeSnapshot guarded{};
+    runPublishBenchmark("std::mutex", readers, 200,
+        [&](const TradeSnapshot& t) { std::lock_guard<std::mutex> lock(mutex); guarded = t; },
+        [&] { std::lock_guard<std::mutex> lock(mutex); return guarded; });
+
+    std::atomic<TradeSnapshot> atomicValue{TradeSnapshot{}};
+    runPublishBenchmark("std::atomic<TradeSnapshot>", readers, 200,
+        [&](const TradeSnapshot& t) { atomicValue.store(t, std::memory_order_release); },
+        [&] { return atomicValue.load(std::memory_order_acquire); });
+}
+
+inline void multicastRingFanOut() {
+    constexpr std::int64_t kEvents = 2'000'000;
+    constexpr std::size_t kBatch = 16;
+
+    for (unsigned consumerCount : {1u, 6u, 10u}) {
+        MulticastRing<TradeSnapshot> ring(4096);
+        std::vector<MulticastRing<TradeSnapshot>::Consumer*> consumers;
+        for (unsigned c = 0; c < consumerCount; ++c) consumers.push_back(&ring.addConsumer());
+
+        std::vector<std::thread> threads;
+        for (auto* consumer : consumers) {
+            threads.emplace_back([&ring, consumer] {
+                long checksum = 0;
+                while (consumer->next() < kEvents) {
+                    const std::int64_t avail = consumer->waitFor(consumer->next());
+                    for (std::int64_t s = consumer->next(); s <= avail; ++s) checksum += ring[s].volume;
+                    consumer->release(avail);
+                }
+                assert(checksum > 0);
+            });
+        }
+
+        const auto start = Clock::now();
+        for (std::int64_t produced = 0; produced < kEvents; produced += kBatch) {
+            const std::int64_t hi = ring.claim(kBatch);
+            for (std::int64_t s = hi - kBatch + 1; s <= hi; ++s) {
+                ring[s] = TradeSnapshot{static_cast<int>(s), 100.0, static_cast<long>(s)};
+            }
+            ring.publish(hi);
+        }
+        for (auto& t : threads) t.join();
+
+        std::printf("MulticastRing consumers=%-2u events/s=%12.0f\n",
+                    consumerCount, kEvents / (elapsedNs(start) / 1e9));
+    }
+}
+
+inline double percentile(AlignedVector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    auto nth = samples.begin() + static_cast<std::ptrdiff_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+inline void mpscQueueProducers() {
+    struct Message : MpscHook {
+        Clock::time_point sent;
+        long payload;
+    };
+    constexpr long kPerProducer = 200'000;
+
+    for (unsigned producerCount : {1u, 2u, 4u, 8u}) {
+        AlignedObjectPool<Message> pool(1024);
+        IntrusiveMpscQueue<Message> queue;
+        const long total = kPerProducer * producerCount;
+        AlignedVector<double> latencies;
+        latencies.reserve(total);
+
+        const auto start = Clock::now();
+        std::vector<std::thread> producers;
+        for (unsigned p = 0; p < producerCount; ++p) {
+            producers.emplace_back([&pool, &queue] {
+                for (long i = 0; i < kPerProducer; ++i) {
+                    Message* m = pool.create();
+                    m->payload = i;
+                    m->sent = Clock::now();
+                    queue.push(m);
+                }
+            });
+        }
+
+        for (long received = 0; received < total;) {
+            if (Message* m = queue.pop()) {
+                latencies.push_back(elapsedNs(m->sent));
+                pool.destroy(m);
+                ++received;
+            }
+        }
+        const double seconds = elapsedNs(start) / 1e9;
+        for (auto& t : producers) t.join();
+
+        std::printf("IntrusiveMpscQueue producers=%-2u msgs/s=%12.0f p50=%8.0fns p99=%10.0fns\n",
+                    producerCount, total / seconds,
+                    percentile(latencies, 0.50), percentile(latencies, 0.99));
+    }
+}
+
+inline void forkJoinScaling() {
+    AlignedVector<double> prices(1 << 22, 100.0);
+    const unsigned maxThreads = threadCount(8);
+    double baseline = 0.0;
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ForkJoinPool pool(threads);
+        const auto start = Clock::now();
+        for (int rep = 0; rep < 10; ++rep) {
+            pool.parallelFor(0, prices.size(), 2048, [&](std::size_t i) {
+                prices[i] = prices[i] * 1.0000001 + 0.5;
+            });
+        }
+        const double ms = elapsedNs(start) / 1e6;
+        if (threads == 1) baseline = ms;
+        std::printf("ForkJoinPool threads=%-2u %8.2f ms speedup=%5.2fx\n", threads, ms, baseline / ms);
+    }
+}
+
+/**
+ * STREAM triad a = b + s * c: main-thread-initialized AlignedVector versus
+ * FirstTouchArray on pinned workers, same pool and page-granular partitions.
+ */
+inline void firstTouchStreamTriad() {
+    constexpr std::size_t kElements = std::size_t{1} << 23;  // 64 MB per array
+    constexpr int kReps = 10;
+    ForkJoinPool pool(threadCount(8));
+    const NumaTopology topo = NumaTopology::detect();
+    const bool pinned = pinWorkersAcrossNodes(pool, topo);
+
+    auto triad = [&](auto& a, const auto& b, const auto& c) {
+        const ContainerPartitioner<std::remove_reference_t<decltype(a)>> parts(a.size(), pool.size(),
+                                                                              PartitionGranularity::Page, a.data());
+        const auto start = Clock::now();
+        for (int rep = 0; rep < kReps; ++rep) {
+            pool.forEachWorker([&](std::size_t w) {
+                for (std::size_t i = parts.begin(w); i < parts.end(w); ++i) a[i] = b[i] + 3.0 * c[i];
+            });
+        }
+        const double bytes = 3.0 * sizeof(double) * kElements * kReps;
+        return bytes / elapsedNs(start);  // GB/s
+    };
+
+    double serialInit = 0.0;
+    {
+        AlignedVector<double, MEMORY_PAGE_SIZE> a(kElements), b(kElements, 1.0), c(kElements, 2.0);
+        serialInit = triad(a, b, c);
+    }
+    double firstTouch = 0.0;
+    {
+        FirstTouchArray<double> a(pool, kElements), b(pool, kElements, 1.0), c(pool, kElements, 2.0);
+        firstTouch = triad(a, b, c);
+    }
+
+    std::printf("STREAM triad nodes=%zu workers=%zu pinned=%d main-thread init=%6.2f GB/s "
+                "first-touch=%6.2f GB/s gain=%5.2fx\n",
+                topo.nodes(), pool.size(), pinned, serialInit, firstTouch, firstTouch / serialInit);
+}
+
+/**
+ * Order-expiry hold model: keep N pending timers, repeatedly expire the earliest
+ * and schedule a new one; a fraction of orders get their expiry moved (decrease-key).
+ */
+inline void priorityQueueExpiry() {
+    constexpr std::size_t kPending = 1 << 20;
+    constexpr int kOps = 2'000'000;
+
+    std::uint64_t seed = 42;
+    auto next = [&] { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
+
+    {
+        AlignedPriorityQueue<std::uint64_t, std::greater<std::uint64_t>> timers;
+        std::vector<std::uint64_t> initial(kPending);
+        for (auto& t : initial) t = next() % (1ull << 40);
+        std::vector<AlignedPriorityQueue<std::uint64_t, std::greater<std::uint64_t>>::Handle> handles;
+        timers.pushBatch(initial.begin(), initial.end(), &handles);
+
+        const auto start = Clock::now();
+        for (int i = 0; i < kOps; ++i) {
+            const std::uint64_t now = timers.top();
+            timers.pop();
+            handles[i % handles.size()] = timers.push(now + next() % (1ull << 30));
+            if ((i & 7) == 0) {
+                const auto h = handles[next() % handles.size()];
+                if (timers.contains(h)) timers.update(h, timers.value(h) / 2);  // Expire sooner
+            }
+        }
+        std::printf("AlignedPriorityQueue (d=%zu) hold: %6.1f ns/op\n",
+                    AlignedPriorityQueue<std::uint64_t>::kArity, elapsedNs(start) / kOps);
+    }
+
+    {
+        seed = 42;
+        std::priority_queue<std::uint64_t, std::vector<std::uint64_t>, std::greater<std::uint64_t>> timers;
+        for (std::size_t i = 0; i < kPending; ++i) timers.push(next() % (1ull << 40));
+
+        const auto start = Clock::now();
+        for (int i = 0; i < kOps; ++i) {
+            const std::uint64_t now = timers.top();
+            timers.pop();
+            timers.push(now + next() % (1ull << 30));
+        }
+        std::printf("std::priority_queue (binary) hold: %6.1f ns/op (no decrease-key)\n", elapsedNs(start) / kOps);
+    }
+}
+
+/**
+ * Random lower_bound over 1M 64-bit keys: std::map node chasing vs the two
+ * AlignedFlatMap layouts. The checksum keeps the lookups from being elided.
+ */
+inline void flatMapLookup() {
+    constexpr std::size_t kKeys = 1 << 20;
+    constexpr int kLookups = 4'000'000;
+
+    std::uint64_t seed = 7;
+    auto next = [&] { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> items(kKeys);
+    for (std::size_t i = 0; i < kKeys; ++i) items[i] = {next(), i};
+    std::vector<std::uint64_t> probes(kLookups);
+    for (auto& p : probes) p = next();
+
+    auto run = [&](const char* name, auto&& lowerBound) {
+        std::uint64_t checksum = 0;
+        const auto start = Clock::now();
+        for (const std::uint64_t p : probes) checksum += lowerBound(p);
+        std::printf("%-28s lower_bound: %6.1f ns/op (checksum %llu)\n", name, elapsedNs(start) / kLookups,
+                    static_cast<unsigned long long>(checksum % 1000));
+    };
+
+    {
+        const std::map<std::uint64_t, std::uint64_t> tree(items.begin(), items.end());
+        run("std::map", [&](std::uint64_t k) {
+            const auto it = tree.lower_bound(k);
+            return it == tree.end() ? 0 : it->second;
+        });
+    }
+    {
+        const AlignedFlatMap<std::uint64_t, std::uint64_t> flat(items.begin(), items.end());
+        run("AlignedFlatMap<Sorted>", [&](std::uint64_t k) {
+            const auto it = flat.lower_bound(k);
+            return it == flat.end() ? 0 : it.value();
+        });
+    }
+    {
+        const AlignedFlatMap<std::uint64_t, std::uint64_t, FlatMapLayout::Eytzinger> flat(items.begin(), items.end());
+        run("AlignedFlatMap<Eytzinger>", [&](std::uint64_t k) {
+            const auto it = flat.lower_bound(k);
+            return it == flat.end() ? 0 : it.value();
+        });
+    }
+}
+
+/**
+ * Bulk mask work on 64M flags: active & ~halted, then count the survivors.
+ * AlignedDynamicBitset runs the dispatched word kernels; vector<bool> goes
+ * through its bit proxies.
+ */
+inline void bitsetBulkOps() {
+    constexpr std::size_t kBits = std::size_t{1} << 26;
+    constexpr int kRounds = 20;
+
+    std::uint64_t seed = 11;
+    auto next = [&] { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
+
+    AlignedDynamicBitset active(kBits), halted(kBits);
+    std::vector<bool> activeRef(kBits), haltedRef(kBits);
+    for (std::size_t i = 0; i < kBits; ++i) {
+        const std::uint64_t r = next();
+        if (r & 1) { active.set(i); activeRef[i] = true; }
+        if ((r & 6) == 0) { halted.set(i); haltedRef[i] = true; }
+    }
+
+    std::size_t total = 0;
+    auto start = Clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        AlignedDynamicBitset tradable = active;
+        tradable.andNot(halted);
+        total += tradable.count();
+    }
+    const double bitsetNs = elapsedNs(start) / kRounds;
+
+    std::size_t totalRef = 0;
+    start = Clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        std::vector<bool> tradable = activeRef;
+        for (std::size_t i = 0; i < kBits; ++i) tradable[i] = tradable[i] && !haltedRef[i];
+        totalRef += static_cast<std::size_t>(std::count(tradable.begin(), tradable.end(), true));
+    }
+    const double vectorNs = elapsedNs(start) / kRounds;
+
+    std::printf("AlignedDynamicBitset (%s) andNot+count: %8.2f ms, vector<bool>: %8.2f ms (%5.1fx)%s\n",
+                bitkernels::kernels().name, bitsetNs / 1e6, vectorNs / 1e6, vectorNs / bitsetNs,
+                total == totalRef ? "" : " MISMATCH");
+}
+
+/**
+ * Order-queue FIFO of 128-byte records whose depth oscillates across block
+ * boundaries: libstdc++ deque (4 per 512-byte block) vs 4 KiB blocks with a spare.
+ */
+inline void blockDequeFifo() {
+    struct alignas(CACHE_LINE_SIZE) Order {
+        long id;
+        char payload[120];
+    };
+    constexpr int kOps = 4'000'000;
+
+    auto run = [](const char* name, auto& fifo) {
+        const auto start = Clock::now();
+        long checksum = 0;
+        for (int i = 0; i < kOps; ++i) {
+            fifo.push(Order{i, {}});
+            if ((i & 3) != 3) continue;  // Burst of 4 in, 4 out
+            for (int j = 0; j < 4; ++j) {
+                checksum += fifo.front().id;
+                fifo.pop();
+            }
+        }
+        std::printf("%-32s push+pop: %6.1f ns/op (checksum %ld)\n", name, elapsedNs(start) / kOps, checksum % 1000);
+    };
+
+    AlignedQueue<Order> stdQueue;
+    run("AlignedQueue (std::deque)", stdQueue);
+    AlignedBlockQueue<Order, 4096> blockQueue;
+    run("AlignedBlockQueue (4 KiB blocks)", blockQueue);
+}
+
+/**
+ * Order-queue churn (append, cancel by id, fill from the front): AlignedList plus
+ * an AlignedUnorderedMap of iterators vs pooled orders on intrusive hooks.
+ */
+inline void intrusiveOrderQueue() {
+    struct Order : ListHook<>, HashHook<> {
+        long id;
+        double price;
+    };
+    struct IdOf {
+        long operator()(const Order& o) const noexcept { return o.id; }
+    };
+    constexpr int kOps = 2'000'000;
+    constexpr long kDepth = 4096;
+
+    {
+        AlignedList<std::pair<long, double>> queue;
+        AlignedUnorderedMap<long, AlignedList<std::pair<long, double>>::iterator> byId;
+        byId.reserve(2 * kDepth);
+        const auto start = Clock::now();
+        for (long i = 0; i < kOps; ++i) {
+            byId.emplace(i, queue.insert(queue.end(), {i, 100.0}));
+            if (i < kDepth) continue;
+            const auto cancel = byId.find(i - kDepth / 2);  // Cancel from the middle...
+            if (cancel != byId.end()) {
+                queue.erase(cancel->second);
+                byId.erase(cancel);
+            }
+            if (!queue.empty()) {  // ...and fill from the front
+                byId.erase(queue.front().first);
+                queue.pop_front();
+            }
+        }
+        std::printf("AlignedList + AlignedUnorderedMap: %6.1f ns/op\n", elapsedNs(start) / kOps);
+    }
+
+    {
+        AlignedObjectPool<Order> pool(4 * kDepth);
+        IntrusiveList<Order> queue;
+        IntrusiveHashTable<Order, IdOf> byId(2 * kDepth);
+        const auto start = Clock::now();
+        for (long i = 0; i < kOps; ++i) {
+            Order* order = pool.create();
+            order->id = i;
+            order->price = 100.0;
+            queue.push_back(*order);
+            byId.insert(*order);
+            if (i < kDepth) continue;
+            if (Order* cancel = byId.erase(i - kDepth / 2)) {
+                queue.erase(*cancel);
+                pool.destroy(cancel);
+            }
+            if (!queue.empty()) {
+                Order& filled = queue.front();
+                queue.pop_front();
+                byId.erase(filled);
+                pool.destroy(&filled);
+            }
+        }
+        std::printf("IntrusiveList + IntrusiveHashTable: %6.1f ns/op (no allocator calls)\n", elapsedNs(start) / kOps);
+        queue.clear();
+        byId.forEach([&](Order& o) { pool.destroy(&o); });
+        byId.clear();
+    }
+}
+
+/**
+ * Book price levels read by 1..32 strategy threads (top-10 range scan) while one
+ * writer adds, updates and removes levels: ConcurrentSkipListMap vs AlignedMap
+ * behind a std::mutex (glibc's reader-preferring shared_mutex starves the writer
+ * outright here). Counts above the core count are oversubscribed.
+ */
+inline void skipListReaders() {
+    constexpr long kLevels = 1000;
+
+    for (unsigned readers : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        ConcurrentSkipListMap<long, long> book;
+        for (long tick = 0; tick < kLevels; ++tick) book.insert_or_assign(tick, 100);
+
+        runPublishBenchmark("ConcurrentSkipListMap", readers, 200,
+            [&](const TradeSnapshot& t) {
+                const long tick = t.timestamp % kLevels;
+                if (t.timestamp % 8 == 0) {
+                    book.erase(tick);
+                } else {
+                    book.insert_or_assign(tick, t.volume);
+                }
+            },
+            [&] {
+                thread_local ConcurrentSkipListMap<long, long>::Reader reader(book);
+                thread_local std::vector<std::pair<long, long>> top;
+                reader.range(0, kLevels, top, 10);
+                return TradeSnapshot{0, 0.0, top.empty() ? 0 : top.front().second};
+            });
+
+        AlignedMap<long, long> lockedBook;
+        std::mutex mutex;
+        for (long tick = 0; tick < kLevels; ++tick) lockedBook[tick] = 100;
+
+        runPublishBenchmark("AlignedMap + std::mutex", readers, 200,
+            [&](const TradeSnapshot& t) {
+                const long tick = t.timestamp % kLevels;
+                std::lock_guard<std::mutex> lock(mutex);
+                if (t.timestamp % 8 == 0) {
+                    lockedBook.erase(tick);
+                } else {
+                    lockedBook[tick] = t.volume;
+                }
+            },
+            [&] {
+                thread_local std::vector<std::pair<long, long>> top;
+                top.clear();
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto it = lockedBook.begin(); it != lockedBook.end() && top.size() < 10; ++it) top.push_back(*it);
+                return TradeSnapshot{0, 0.0, top.empty() ? 0 : top.front().second};
+            });
+    }
+}
+
+/**
+ * Symbol resolution on the feed path: threads look up known tickers (90%) and
+ * intern new ones (10%). Sharded SymbolTable vs one std::unordered_map<std::string>
+ * behind a std::mutex.
+ */
+inline void symbolInterning() {
+    constexpr int kOpsPerThread = 400'000;
+    constexpr int kKnown = 8192;
+
+    std::vector<std::string> known;
+    for (int i = 0; i < kKnown; ++i) known.push_back("SYM" + std::to_string(i) + ".XNAS");
+
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        auto run = [&](const char* name, auto&& resolve) {
+            std::vector<std::thread> workers;
+            const auto start = Clock::now();
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    std::uint64_t seed = 88172645463325252ull + t;
+                    std::string fresh;
+                    std::uint64_t checksum = 0;
+                    for (int i = 0; i < kOpsPerThread; ++i) {
+                        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+                        if (seed % 10 == 0) {
+                            fresh = "NEW" + std::to_string(t) + "." + std::to_string(i);
+                            checksum += resolve(fresh);
+                        } else {
+                            checksum += resolve(known[seed % kKnown]);
+                        }
+                    }
+                    assert(checksum > 0);
+                });
+            }
+            for (auto& w : workers) w.join();
+            std::printf("%-34s threads=%-2u ops/s=%12.0f\n", name, threads,
+                        threads * kOpsPerThread / (elapsedNs(start) / 1e9));
+        };
+
+        SymbolTable table;
+        for (const auto& s : known) table.intern(s);
+        run("SymbolTable (sharded)", [&](std::string_view s) { return table.intern(s); });
+
+        std::unordered_map<std::string, SymbolId> map;
+        std::mutex mutex;
+        for (const auto& s : known) map.emplace(s, static_cast<SymbolId>(map.size()));
+        run("unordered_map<string> + mutex", [&](std::string_view s) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return map.try_emplace(std::string(s), static_cast<SymbolId>(map.size())).first->second;
+        });
+    }
+}
+
+/**
+ * Encoding a FIX NewOrderSingle per trade: std::string concatenation (fresh
+ * buffers every message) vs a pooled MessageBuilder that keeps its buffer.
+ */
+inline void messageEncoding() {
+    constexpr int kMessages = 1'000'000;
+    std::size_t bytes = 0;
+
+    auto start = Clock::now();
+    for (int i = 0; i < kMessages; ++i) {
+        std::string msg = "8=FIX.4.4\x01" "35=D\x01" "11=" + std::to_string(i) + "\x01" "55=AAPL\x01" "44=" +
+                          std::to_string(100.0 + i % 100) + "\x01" "38=" + std::to_string(100 + i % 7) + "\x01";
+        bytes += msg.size();
+    }
+    std::printf("std::string concatenation:   %6.1f ns/msg\n", elapsedNs(start) / kMessages);
+
+    MessageBuilderPool pool;
+    start = Clock::now();
+    for (int i = 0; i < kMessages; ++i) {
+        auto msg = pool.acquire();
+        msg->fixField(8, "FIX.4.4").fixField(35, "D").fixField(11, i).fixField(55, "AAPL")
+            .fixField(44, 100.0 + i % 100).fixField(38, 100 + i % 7);
+        bytes += msg->size();
+    }
+    std::printf("MessageBuilderPool lease:    %6.1f ns/msg (bytes %zu)\n", elapsedNs(start) / kMessages, bytes % 1000);
+}
+
+inline void timeSeriesRangeQuery() {
+    constexpr int kTrades = 4'000'000;
+    constexpr int kQueries = 200;
+    AlignedVector<TradeSnapshot> rows;
+    rows.reserve(kTrades);
+    TimeSeriesStore<> store;
+    for (int i = 0; i < kTrades; ++i) {
+        const TradeSnapshot trade{1 + i % 500, 100.0 + (i % 1000) * 0.01, static_cast<long>(i) * 1000};
+        rows.push_back(trade);
+        store.append(trade.timestamp, trade.price, trade.volume);
+    }
 
-        // Optimization: Skip alignment if type is already sufficiently aligned
-        if constexpr (alignof(T) >= Alignment) {
-            return static_cast<T*>(::operator new(n * sizeof(T)));
+    // Five-minute style windows: ~2% of the day each
+    const long window = static_cast<long>(kTrades / 50) * 1000;
+    double checksum = 0.0;
+    auto start = Clock::now();
+    for (int q = 0; q < kQueries; ++q) {
+        const long from = (static_cast<long>(q) * 7919 % kTrades) * 1000;
+        long long volume = 0;
+        double notional = 0.0;
+        for (const TradeSnapshot& t : rows) {
+            const bool in = (t.timestamp >= from) & (t.timestamp < from + window);
+            volume += in ? t.volume : 0;
+            notional += in ? t.price * t.volume : 0.0;
         }
+        checksum += volume ? notional / static_cast<double>(volume) : 0.0;
+    }
+    std::printf("row scan (AlignedVector):    %8.1f us/query\n", elapsedNs(start) / kQueries / 1000.0);
 
-        void* ptr = nullptr;
-        const std::size_t size = n * sizeof(T);
+    RangeAggregate last;
+    start = Clock::now();
+    for (int q = 0; q < kQueries; ++q) {
+        const long from = (static_cast<long>(q) * 7919 % kTrades) * 1000;
+        last = store.aggregate(from, from + window);
+        checksum -= last.vwap();
+    }
+    std::printf("TimeSeriesStore zone maps:   %8.1f us/query (scanned %zu, stats %zu, skipped %zu; diff %.3g)\n",
+                elapsedNs(start) / kQueries / 1000.0, last.chunksScanned, last.chunksFromStats, last.chunksSkipped,
+                checksum);
+}
 
-#if defined(_MSC_VER)
-        // Windows aligned allocation
-        ptr = _aligned_malloc(size, Alignment);
-#else
-        // POSIX aligned allocation
-        if (posix_memalign(&ptr, Alignment, size) != 0) {
-            throw std::bad_alloc();
+#if !defined(_WIN32)
+inline void directTickFileLoad() {
+    constexpr std::size_t kBytes = std::size_t{64} << 20;
+    const std::string path = "aligned_io_bench.bin";
+    AlignedVector<std::byte, MEMORY_PAGE_SIZE> ticks(kBytes);
+    for (std::size_t i = 0; i < kBytes; i += sizeof(TradeSnapshot)) ticks[i] = std::byte(i);
+    if (!storeFileDirect(path, ticks)) {
+        std::printf("direct I/O benchmark skipped: cannot write %s\n", path.c_str());
+        return;
+    }
+    const double mb = static_cast<double>(kBytes) / (1 << 20);
+
+    auto start = Clock::now();
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> buffered(kBytes);
+        in.read(buffered.data(), static_cast<std::streamsize>(kBytes));
+    }
+    std::printf("ifstream (page cache + copy):  %8.0f MB/s\n", mb / (elapsedNs(start) / 1e9));
+
+    AlignedIoRing probe(1);
+    AlignedVector<std::byte, MEMORY_PAGE_SIZE> loaded;
+    start = Clock::now();
+    const bool ok = loadFileDirect(path, loaded);
+    std::printf("loadFileDirect (%s):    %8.0f MB/s (%s)\n", probe.usingIoUring() ? "io_uring" : "pread   ",
+                mb / (elapsedNs(start) / 1e9), ok && loaded == ticks ? "verified" : "FAILED");
+    std::remove(path.c_str());
+}
+#endif
+
+#if !defined(_WIN32)
+inline void journalRecording() {
+    constexpr int kEvents = 1'000'000;
+    constexpr int kBatch = 64;  // Timed in batches; a clock read costs as much as a record
+    const std::string base = "aligned_journal_bench";
+    const TradeSnapshot trade{100, 150.25, 1234567890};
+
+    const std::string writePath = base + ".write";
+    const int fd = ::open(writePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return;
+    auto start = Clock::now();
+    for (int i = 0; i < kEvents; ++i) {
+        if (::write(fd, &trade, sizeof(trade)) != static_cast<ssize_t>(sizeof(trade))) break;
+    }
+    std::printf("write() per event:           %7.1f ns/event\n", elapsedNs(start) / kEvents);
+    ::close(fd);
+    ::unlink(writePath.c_str());
+
+    std::uint64_t retries = 0;
+    AlignedVector<double> perRecord;
+    perRecord.reserve(kEvents / kBatch);
+    {
+        EventJournal journal(base, std::size_t{64} << 20, std::size_t{1} << 20);
+        journal.startFlusher();
+        EventJournal::Producer producer(journal);
+        for (int b = 0; b < kEvents / kBatch; ++b) {
+            const auto batchStart = Clock::now();
+            for (int i = 0; i < kBatch; ++i) {
+                while (!producer.record(1, trade)) std::this_thread::yield();  // Flusher behind: ring full
+            }
+            perRecord.push_back(elapsedNs(batchStart) / kBatch);
         }
+        retries = producer.dropped();
+    }
+    std::printf("EventJournal record():       p50 %5.1f ns  p99 %6.1f ns  (ring-full retries %llu)\n",
+                percentile(perRecord, 0.50), percentile(perRecord, 0.99), static_cast<unsigned long long>(retries));
+
+    long long volume = 0;
+    start = Clock::now();
+    const std::size_t replayed = EventJournal::replay(base, [&](const JournalRecordView& record) {
+        volume += record.as<TradeSnapshot>().volume;
+    });
+    std::printf("EventJournal::replay (mmap): %7.1f ns/record (%zu records, volume %lld)\n",
+                elapsedNs(start) / static_cast<double>(std::max<std::size_t>(replayed, 1)), replayed, volume);
+
+    for (std::size_t i = 0; ::unlink(EventJournal::segmentPath(base, i).c_str()) == 0; ++i) {}
+}
 #endif
 
-        // Verify allocation succeeded
-        if (!ptr) throw std::bad_alloc();
+#if !defined(_WIN32)
+inline void snapshotRestart() {
+    constexpr std::size_t kTrades = 4'000'000;
+    constexpr int kPositions = 500'000;
+    const std::string path = "aligned_snapshot_bench.snap";
+    struct Position {
+        long quantity;
+        double averagePrice;
+    };
 
-        // Debug check for correct alignment
-        assert(reinterpret_cast<uintptr_t>(ptr) % Alignment == 0);
+    AlignedVector<TradeSnapshot> trades(kTrades);
+    for (std::size_t i = 0; i < kTrades; ++i) trades[i] = {static_cast<int>(i % 500), 100.0 + i % 100, static_cast<long>(i)};
+    // Containers are declared outside the timed scopes: only the build/load work is measured
+    AlignedUnorderedMap<int, Position> positions;
+    auto start = Clock::now();
+    positions.reserve(kPositions);
+    for (int i = 0; i < kPositions; ++i) positions.emplace(i * 7, Position{i, 100.0 + i % 50});
+    std::printf("rebuild positions (emplace): %8.2f ms\n", elapsedNs(start) / 1e6);
 
-        return static_cast<T*>(ptr);
+    start = Clock::now();
+    SnapshotWriter writer(path);
+    writer.add("trades", trades);
+    writer.add("positions", positions);
+    if (!writer.commit()) {
+        std::printf("snapshot benchmark skipped: cannot write %s\n", path.c_str());
+        return;
     }
+    std::printf("snapshot commit (+fsync):    %8.2f ms\n", elapsedNs(start) / 1e6);
 
-    /**
-     * Deallocates memory previously allocated by allocate().
-     * @param p Pointer to memory to deallocate
-     * @param n Number of elements (unused but required by interface)
-     */
-    void deallocate(T* p, std::size_t) noexcept {
-#if defined(_MSC_VER)
-        _aligned_free(p);
-#else
-        free(p);  // free() works with posix_memalign allocations
+    {
+        SnapshotImage image;
+        start = Clock::now();
+        const bool opened = image.open(path);
+        const auto view = image.view<TradeSnapshot>("trades");
+        long long volume = 0;
+        for (const TradeSnapshot& t : view) volume += t.volume;
+        std::printf("mmap + view + scan:          %8.2f ms (%zu trades, volume %lld%s)\n", elapsedNs(start) / 1e6,
+                    view.size(), volume, opened ? "" : ", FAILED");
+    }
+
+    {
+        SnapshotImage image;
+        AlignedVector<TradeSnapshot> restoredTrades;
+        AlignedUnorderedMap<int, Position> restoredPositions;
+        start = Clock::now();
+        bool ok = image.open(path, SnapshotImage::Load::Read);
+        std::printf("O_DIRECT load (batched):     %8.2f ms\n", elapsedNs(start) / 1e6);
+        start = Clock::now();
+        ok = ok && image.restore("trades", restoredTrades);
+        std::printf("restore trades (one copy):   %8.2f ms\n", elapsedNs(start) / 1e6);
+        start = Clock::now();
+        ok = ok && image.restore("positions", restoredPositions);
+        std::printf("restore positions (map):     %8.2f ms (%s)\n", elapsedNs(start) / 1e6,
+                    ok && restoredTrades.size() == kTrades && restoredPositions.size() == positions.size()
+                        ? "verified" : "FAILED");
+    }
+    std::remove(path.c_str());
+}
 #endif
+
+inline void packedColumnScan() {
+    constexpr std::size_t kTrades = 8'000'000;
+    constexpr int kRepeats = 5;
+    AlignedVector<long> timestamps(kTrades);
+    AlignedVector<double> prices(kTrades);
+    AlignedVector<int> volumes(kTrades);
+    long ts = 1'700'000'000'000'000'000L;
+    for (std::size_t i = 0; i < kTrades; ++i) {
+        ts += 1000 + static_cast<long>((i * 2654435761u) % 50'000);  // Irregular, increasing nanosecond prints
+        timestamps[i] = ts;
+        prices[i] = static_cast<double>(15'000 + (i * 40503u) % 2'000) / 100.0;
+        volumes[i] = 1 + static_cast<int>((i * 69069u) % 500);
     }
+    const long from = timestamps[kTrades / 4];
+    const long to = timestamps[3 * kTrades / 4];
 
-    /**
-     * Allocator equality comparison (C++20)
-     * Two allocators are equal if they have the same alignment requirements
-     */
-    template<typename U, std::size_t A2>
-    bool operator==(const AlignedAllocator<U, A2>& other) const noexcept { 
-        return Alignment == A2; 
+    double checksum = 0.0;
+    auto start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r) {
+        long long volume = 0;
+        double notional = 0.0;
+        for (std::size_t i = 0; i < kTrades; ++i) {
+            const bool in = (timestamps[i] >= from) & (timestamps[i] < to);
+            volume += in ? volumes[i] : 0;
+            notional += in ? prices[i] * volumes[i] : 0.0;
+        }
+        checksum += notional / static_cast<double>(volume);
     }
+    const std::size_t rawBytes = kTrades * (sizeof(long) + sizeof(double) + sizeof(int));
+    std::printf("raw AlignedVector columns:   %7.2f ms/scan, %6.1f MB read\n", elapsedNs(start) / kRepeats / 1e6,
+                rawBytes / 1e6);
 
-    /**
-     * Allocator inequality comparison (C++20)
-     */
-    template<typename U, std::size_t A2>
-    bool operator!=(const AlignedAllocator<U, A2>& other) const noexcept { 
-        return !(*this == other); 
+    const PackedIntColumn packedTimes(std::span<const long>(timestamps), ColumnEncoding::Delta);
+    const PackedPriceColumn packedPrices(prices, 100);
+    const PackedIntColumn packedVolumes(std::span<const int>(volumes), ColumnEncoding::FrameOfReference);
+    alignas(CACHE_LINE_SIZE) std::int64_t timeBlock[PackedIntColumn::kBlockValues];
+    alignas(CACHE_LINE_SIZE) double priceBlock[PackedIntColumn::kBlockValues];
+    alignas(CACHE_LINE_SIZE) std::int64_t volumeBlock[PackedIntColumn::kBlockValues];
+
+    start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r) {
+        long long volume = 0;
+        double notional = 0.0;
+        for (std::size_t b = 0; b < packedTimes.blockCount(); ++b) {
+            const std::size_t n = packedTimes.decodeBlock(b, timeBlock);
+            packedPrices.decodeTicks(b, priceBlock);
+            packedVolumes.decodeBlock(b, volumeBlock);
+            for (std::size_t i = 0; i < n; ++i) {
+                const bool in = (timeBlock[i] >= from) & (timeBlock[i] < to);
+                volume += in ? volumeBlock[i] : 0;
+                notional += in ? priceBlock[i] * static_cast<double>(volumeBlock[i]) : 0.0;
+            }
+        }
+        checksum -= notional / packedPrices.ticksPerUnit() / static_cast<double>(volume);
     }
-};
+    const std::size_t packedBytes =
+        packedTimes.compressedBytes() + packedPrices.compressedBytes() + packedVolumes.compressedBytes();
+    std::printf("packed columns (%s):      %7.2f ms/scan, %6.1f MB read (%.1fx smaller; diff %.3g)\n",
+                packkernels::kernels().name, elapsedNs(start) / kRepeats / 1e6, packedBytes / 1e6,
+                static_cast<double>(rawBytes) / static_cast<double>(packedBytes), checksum);
+}
 
-// ========== Aligned Container Aliases ========== //
-template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
-using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+/**
+ * Replays one allocation script against `Backend`, timing every call, and
+ * prints median, tail and worst-case latency.
+ */
+template<typename Backend>
+void runAllocationScript(const char* pattern, const std::vector<std::array<std::uint32_t, 3>>& script,
+                         std::size_t slots) {
+    std::vector<void*> live(slots, nullptr);
+    std::vector<std::size_t> sizes(slots, 0), alignments(slots, 0);
+    AlignedVector<double> latencies(script.size());
 
-template<typename Key, typename T, std::size_t Alignment = CACHE_LINE_SIZE>
-using AlignedUnorderedMap = std::unordered_map<Key, T, std::hash<Key>, 
-                                              std::equal_to<Key>,
-                                              AlignedAllocator<std::pair<const Key, T>, Alignment>>;
+    for (std::size_t i = 0; i < script.size(); ++i) {
+        const auto [slot, bytes, alignment] = script[i];
+        const auto start = Clock::now();
+        if (live[slot]) {
+            Backend::deallocate(live[slot], sizes[slot], alignments[slot]);
+            live[slot] = nullptr;
+        } else {
+            live[slot] = Backend::allocate(bytes, alignment);
+            static_cast<volatile char*>(live[slot])[0] = 0;
+            sizes[slot] = bytes;
+            alignments[slot] = alignment;
+        }
+        latencies[i] = elapsedNs(start);
+    }
+    for (std::size_t s = 0; s < slots; ++s) {
+        if (live[s]) Backend::deallocate(live[s], sizes[s], alignments[s]);
+    }
+    std::printf("%-10s %-9s p50=%6.0f ns  p99.9=%8.0f ns  max=%10.0f ns\n", pattern, Backend::name,
+                percentile(latencies, 0.50), percentile(latencies, 0.999), percentile(latencies, 1.0));
+}
 
-template<typename Key, typename T, std::size_t Alignment = CACHE_LINE_SIZE>
-using AlignedMap = std::map<Key, T, std::less<Key>,
-                           AlignedAllocator<std::pair<const Key, T>, Alignment>>;
+inline void tlsfWorstCase() {
+    using Script = std::vector<std::array<std::uint32_t, 3>>;  // {slot, bytes, alignment}; toggles the slot
+    constexpr std::size_t kSlots = 1024;
+    std::uint64_t seed = 0x9E3779B97F4A7C15ull;
+    auto next = [&] { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
 
-template<typename Key, std::size_t Alignment = CACHE_LINE_SIZE>
-using AlignedSet = std::set<Key, std::less<Key>,
-                           AlignedAllocator<Key, Alignment>>;
+    // Sawtooth: interleave tiny and large blocks, free the large ones, then ask for
+    // sizes just too big for any hole - defeats allocators that search free lists
+    Script sawtooth;
+    for (int round = 0; round < 40; ++round) {
+        for (std::uint32_t s = 0; s < kSlots; ++s) sawtooth.push_back({s, s % 2 ? 24u : 24'000u, 16});
+        for (std::uint32_t s = 0; s < kSlots; s += 2) sawtooth.push_back({s, 0, 0});
+        for (std::uint32_t s = 0; s < kSlots; s += 2) sawtooth.push_back({s, 24'100, 16});
+        for (std::uint32_t s = 0; s < kSlots; ++s) sawtooth.push_back({s, 0, 0});
+    }
 
-template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
-using AlignedList = std::list<T, AlignedAllocator<T, Alignment>>;
+    // Random churn: log-uniform sizes 16 B..256 KiB (across the mmap threshold), alignment 16..4096
+    Script churn;
+    std::vector<bool> occupied(kSlots, false);
+    for (int i = 0; i < 400'000; ++i) {
+        const auto slot = static_cast<std::uint32_t>(next() % kSlots);
+        const auto bytes = static_cast<std::uint32_t>(16u << (next() % 15)) + static_cast<std::uint32_t>(next() % 16);
+        const auto alignment = static_cast<std::uint32_t>(16u << (next() % 9));
+        churn.push_back({slot, bytes, alignment});
+        occupied[slot] = !occupied[slot];
+    }
+    for (std::uint32_t s = 0; s < kSlots; ++s) {
+        if (occupied[s]) churn.push_back({s, 0, 0});
+    }
 
-template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
-using AlignedDeque = std::deque<T, AlignedAllocator<T, Alignment>>;
+    TlsfHeap::instance();  // Map and pre-fault outside the timed region
+    for (const auto& [name, script] : {std::pair<const char*, const Script&>{"sawtooth", sawtooth},
+                                       std::pair<const char*, const Script&>{"churn", churn}}) {
+        runAllocationScript<SystemAlignedBackend>(name, script, kSlots);
+        runAllocationScript<PooledAlignedBackend>(name, script, kSlots);
+        runAllocationScript<TlsfAlignedBackend>(name, script, kSlots);
+    }
+}
 
-// Note: queue/stack adapters don't benefit from alignment directly
-// but their underlying container (deque/list) can use our allocator
-template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
-using AlignedQueue = std::queue<T, AlignedDeque<T, Alignment>>;
+inline void runAll() {
+    seqLockVsMutexVsAtomic();
+    multicastRingFanOut();
+    mpscQueueProducers();
+    forkJoinScaling();
+    firstTouchStreamTriad();
+    priorityQueueExpiry();
+    flatMapLookup();
+    bitsetBulkOps();
+    blockDequeFifo();
+    intrusiveOrderQueue();
+    skipListReaders();
+    symbolInterning();
+    messageEncoding();
+    timeSeriesRangeQuery();
+    packedColumnScan();
+    tlsfWorstCase();
+#if !defined(_WIN32)
+    directTickFileLoad();
+    journalRecording();
+    snapshotRestart();
+#endif
+}
 
-// ========== Example Usage ========== //
-struct TradeData {
-    alignas(CACHE_LINE_SIZE) std::atomic<int> volume;
-    double price;
-    long timestamp;
-};
+}  // namespace bench
+#endif
+
+// Built as the LD_PRELOAD shim the examples and tools are left out
+#if !defined(ALIGNED_ALLOCATOR_PRELOAD)
+int main(int argc, char* argv[]) {
+    // Allocation trace replay tool: ./AlignedAllocator --replay <trace file>
+    if (argc == 3 && std::string(argv[1]) == "--replay") {
+        return replayAllocationTrace(argv[2]) ? 0 : 1;
+    }
 
-int main() {
     // 1. Vector - optimal for sequential access
     {
         AlignedVector<TradeData> trades(100);
@@ -315,5 +8451,478 @@ int main() {
         td.data.push_back(10);  // Data and counter are properly aligned
     }
 
+    // 15. Seqlock snapshot cells - latest trade per symbol, readers never block the feed
+    {
+        SnapshotCellArray<TradeSnapshot> latest(16);  // One cell per symbol
+        assert(reinterpret_cast<uintptr_t>(&latest[1]) % CACHE_LINE_SIZE == 0);
+
+        latest[3].store({100, 150.25, 1234567890});  // Feed thread
+        TradeSnapshot snap = latest[3].load();       // Any strategy thread
+        assert(snap.volume == 100 && snap.timestamp == 1234567890);
+
+        TradeSnapshot attempt;
+        if (latest[3].tryLoad(attempt)) {            // Non-spinning variant
+            assert(attempt.price == 150.25);
+        }
+    }
+
+    // 16. Multicast ring - publish once, every consumer reads the same slot
+    {
+        MulticastRing<TradeSnapshot> ring(1024);
+        auto& journal = ring.addConsumer();           // Independent consumer
+        auto& parse = ring.addConsumer();
+        auto& risk = ring.addConsumer({&parse});      // Runs after parse
+
+        const std::int64_t hi = ring.claim(2);        // Batch claim
+        ring[hi - 1] = {100, 150.25, 1234567890};
+        ring[hi] = {200, 150.50, 1234567891};
+        ring.publish(hi);
+
+        assert(risk.available() < risk.next());       // parse has not released yet
+        parse.release(parse.waitFor(parse.next()));
+        assert(risk.waitFor(risk.next()) == hi);
+        assert(ring[risk.next()].volume == 100);
+        risk.release(hi);
+        journal.release(journal.waitFor(0));
+    }
+
+    // 17. Intrusive MPSC queue - many producers, one consumer, nodes from an aligned pool
+    {
+        struct Order : MpscHook {
+            int id;
+            double price;
+            Order(int i, double p) : id(i), price(p) {}
+        };
+
+        AlignedObjectPool<Order> pool;
+        IntrusiveMpscQueue<Order> queue;
+
+        queue.push(pool.create(1, 150.25));           // Any producer thread
+        queue.push(pool.create(2, 150.50));
+
+        Order* first = queue.pop();                   // Consumer thread
+        assert(first && first->id == 1);
+        assert(reinterpret_cast<uintptr_t>(first) % CACHE_LINE_SIZE == 0);
+        pool.destroy(first);                          // Recycled, not freed
+
+        Order* second = queue.pop();
+        assert(second && second->id == 2);
+        pool.destroy(second);
+        assert(queue.pop() == nullptr && queue.empty());
+    }
+
+    // 18. Work-stealing fork-join pool - per-symbol analytics over aligned partitions
+    {
+        ForkJoinPool pool(2);
+        AlignedVector<double> prices(10000, 150.0);
+        pool.parallelFor(0, prices.size(), 256, [&](std::size_t i) { prices[i] += 0.25; });
+        assert(prices.front() == 150.25 && prices.back() == 150.25);
+
+        double left = 0, right = 0;
+        pool.run([&] {
+            pool.invoke([&] { for (std::size_t i = 0; i < 5000; ++i) left += prices[i]; },
+                        [&] { for (std::size_t i = 5000; i < 10000; ++i) right += prices[i]; });
+        });
+        assert(left == right);
+    }
+
+    // 19. Parallel algorithms - partitions never split a cache line between workers
+    {
+        ForkJoinPool pool(3);
+        AlignedVector<double> prices(1000, 1.0);
+
+        AlignedPartitioner<double> parts(prices.size(), pool.size());
+        assert(reinterpret_cast<uintptr_t>(&prices[parts.begin(1)]) % CACHE_LINE_SIZE == 0);
+
+        parallelForEach(pool, prices, [](double& p) { p *= 2.0; });
+        AlignedVector<double> notional;
+        parallelTransform(pool, prices, notional, [](double p) { return p * 100.0; });
+        assert(notional.size() == prices.size() && notional[999] == 200.0);
+
+        assert(parallelReduce(pool, prices, 0.0, std::plus<>()) == 2000.0);
+
+        AlignedVector<long> volumes(1000, 1);
+        parallelInclusiveScan(pool, volumes, volumes);  // In place
+        assert(volumes[0] == 1 && volumes[999] == 1000);
+
+        AlignedVector<int> ids = {5, 3, 9, 1, 7};
+        parallelSort(pool, ids);
+        assert(std::is_sorted(ids.begin(), ids.end()));
+    }
+
+    // 20. NUMA first-touch - pages land on the node of the worker that processes them
+    {
+        ForkJoinPool pool(2);
+        pinWorkersAcrossNodes(pool);                  // No-op placement on single-node boxes
+
+        FirstTouchArray<double> prices(pool, 4096);   // Zeroed in parallel, page-aligned
+        assert(reinterpret_cast<uintptr_t>(prices.data()) % MEMORY_PAGE_SIZE == 0);
+        assert(prices[4095] == 0.0);
+
+        parallelForEach(pool, prices, [](double& p) { p = 150.25; }, PartitionGranularity::Page);
+        assert(parallelReduce(pool, prices, 0.0, std::plus<>()) == 150.25 * 4096);
+    }
+
+    // 21. Allocation tracing - record real allocation patterns, replay them offline
+    {
+        using TracedVector = std::vector<int, AlignedAllocator<int, CACHE_LINE_SIZE, TracingBackend<>>>;
+
+        const std::string tracePath = "example.aatrace";
+        if (AllocationTraceRecorder::start(tracePath)) {
+            TracedVector v;
+            for (int i = 0; i < 100; ++i) v.push_back(i);  // Each growth is an allocate + deallocate
+            AllocationTraceRecorder::stop();
+        }
+
+        AllocationTraceReplayer replayer;
+        if (replayer.load(tracePath)) {
+            assert(replayer.operations() > 0);
+            const ReplayReport report = replayer.replay<SystemAlignedBackend>();
+            assert(report.operations == replayer.operations());
+        }
+        std::remove(tracePath.c_str());
+    }
+
+    // 22. Pooled slab backend - utilization and fragmentation metrics
+    {
+        std::map<int, TradeSnapshot, std::less<int>,
+                 PooledAlignedAllocator<std::pair<const int, TradeSnapshot>>> book;
+        for (int i = 0; i < 1000; ++i) book[i] = {i, 150.0, 1234567890};
+        for (int i = 0; i < 1000; i += 2) book.erase(i);  // Leaves half-empty slabs behind
+
+        const PoolStats stats = PooledAlignedBackend::stats();
+        for (const SizeClassStats& c : stats.classes) {
+            assert(c.liveObjects + c.freeObjects == c.slabs * (SlabEngine::kSlabSize / c.blockSize));
+        }
+        assert(stats.externalFragmentation >= 0.0 && stats.externalFragmentation <= 1.0);
+
+        const std::string mapPath = "slab_occupancy.txt";
+        if (PooledAlignedBackend::dumpOccupancy(mapPath)) {  // One line per slab, '#' live / '.' free
+            std::remove(mapPath.c_str());
+        }
+    }
+
+    // 23. Cache-line d-ary heap - order-expiry timers with decrease-key
+    {
+        struct Expiry {
+            long timestamp;
+            long orderId;
+            bool operator>(const Expiry& other) const { return timestamp > other.timestamp; }
+        };
+
+        AlignedPriorityQueue<Expiry, std::greater<Expiry>> timers;  // Min-heap, 4 children per line
+        auto h = timers.push({1234567899, 1});
+        timers.push({1234567891, 2});
+
+        std::vector<Expiry> batch = {{1234567895, 3}, {1234567893, 4}};
+        timers.pushBatch(batch.begin(), batch.end());
+        assert(timers.top().orderId == 2);
+
+        timers.update(h, {1234567890, 1});  // Decrease-key: order 1 now expires first
+        assert(timers.top().orderId == 1);
+        timers.pop();
+        assert(timers.top().orderId == 2 && timers.size() == 3);
+    }
+
+    // 24. Flat map - read-mostly symbol table with cache-friendly lookups
+    {
+        std::vector<std::pair<int, TradeSnapshot>> refData = {
+            {3002, {200, 99.5, 1234567892}}, {1001, {100, 101.5, 1234567890}}, {2005, {50, 250.0, 1234567891}}};
+
+        AlignedFlatMap<int, TradeSnapshot, FlatMapLayout::Eytzinger> symbols(refData.begin(), refData.end());
+        assert(symbols.size() == 3 && symbols.at(2005).volume == 50);
+        assert(!symbols.contains(1500) && symbols.lower_bound(1500).key() == 2005);
+
+        int previous = 0;
+        for (const auto& [id, snapshot] : symbols) {  // Always in key order
+            assert(id > previous);
+            previous = id;
+        }
+    }
+
+    // 25. Aligned bitsets - active-order masks with rank/select
+    {
+        AlignedDynamicBitset active(1000), halted(1000);  // One bit per instrument
+        active.set(7).set(42).set(512).set(999);
+        halted.set(42);
+
+        AlignedDynamicBitset tradable = active;
+        tradable.andNot(halted);
+        assert(tradable.count() == 3 && !tradable.test(42));
+        assert(tradable.rank(600) == 2 && tradable.select(2) == 999);
+
+        std::size_t visited = 0;
+        for (std::size_t id = tradable.findFirst(); id != AlignedDynamicBitset::npos; id = tradable.findNext(id)) {
+            ++visited;
+        }
+        assert(visited == 3);
+
+        AlignedBitset<256> levels;  // Fixed size: exactly one cache line
+        levels.set(3).set(200);
+        assert(sizeof(levels) == CACHE_LINE_SIZE && levels.findNext(3) == 200);
+    }
+
+    // 26. Rolling window - 10-second TWAP, high and low without allocating
+    {
+        auto price = [](const TradeSnapshot& t) { return t.price; };
+        AlignedRingWindow<TradeSnapshot, decltype(price)> window(1024, price);  // Ring sized once
+
+        for (long ts = 1234567890; ts < 1234567920; ++ts) {
+            window.push_back({100, 100.0 + static_cast<double>(ts % 5), ts});
+            window.evictWhile([&](const TradeSnapshot& t) { return t.timestamp <= ts - 10; });
+        }
+        assert(window.size() == 10 && window.max() == 104.0 && window.min() == 100.0);
+        const double twap = window.sum() / static_cast<double>(window.size());
+        assert(twap == 102.0);
+
+        auto [older, newer] = window.spans();  // Contiguous runs for SIMD kernels
+        assert(older.size() + newer.size() == window.size());
+    }
+
+    // 27. Block deque - FIFO with page-sized blocks and a recycled spare
+    {
+        AlignedBlockQueue<TradeSnapshot, 4096> pending;  // 170 snapshots per block instead of 21
+        for (int i = 0; i < 1000; ++i) pending.push({i, 100.0, 1234567890 + i});
+        for (int i = 0; i < 1000; ++i) {
+            assert(pending.front().volume == i);
+            pending.pop();
+        }
+
+        AlignedBlockDeque<TradeData, 4096> history;
+        history.emplace_back();
+        history.emplace_front();
+        assert(history.size() == 2 && reinterpret_cast<uintptr_t>(&history[1]) % CACHE_LINE_SIZE == 0);
+    }
+
+    // 28. Intrusive containers - price-level queue and id index without per-node allocation
+    {
+        struct RestingOrder : ListHook<>, HashHook<> {
+            long orderId;
+            TradeSnapshot trade;
+        };
+        struct OrderIdOf {
+            long operator()(const RestingOrder& o) const { return o.orderId; }
+        };
+
+        AlignedObjectPool<RestingOrder> orders;
+        IntrusiveList<RestingOrder> level;                   // Time priority
+        IntrusiveHashTable<RestingOrder, OrderIdOf> byId(64);  // Cancel lookup
+
+        for (long id = 1; id <= 3; ++id) {
+            RestingOrder* order = orders.create();
+            order->orderId = id;
+            order->trade = {100, 101.5, 1234567890 + id};
+            level.push_back(*order);
+            byId.insert(*order);
+        }
+
+        RestingOrder* cancelled = byId.erase(2L);  // O(1) unlink from the middle
+        level.erase(*cancelled);
+        orders.destroy(cancelled);
+        assert(level.size() == 2 && level.front().orderId == 1 && level.back().orderId == 3);
+
+        while (!level.empty()) {
+            RestingOrder& filled = level.front();
+            level.pop_front();
+            byId.erase(filled);
+            orders.destroy(&filled);
+        }
+        assert(byId.empty());
+    }
+
+    // 29. Concurrent skiplist - price levels scanned while the book updates
+    {
+        ConcurrentSkipListMap<long, long> bids;  // Price in ticks -> resting quantity
+        bids.insert_or_assign(10150, 300);
+        bids.insert_or_assign(10100, 500);
+        bids.insert_or_assign(10125, 200);
+
+        std::thread strategy([&bids] {
+            ConcurrentSkipListMap<long, long>::Reader reader(bids);  // One per reading thread
+            std::vector<std::pair<long, long>> levels;
+            reader.range(10100, 10200, levels, 2);  // Consistent snapshot of two levels
+            assert(levels.size() == 2 && levels[0].first < levels[1].first);
+        });
+        bids.insert_or_assign(10125, 250);  // Writer keeps going; readers never block it
+        bids.erase(10150);
+        strategy.join();
+
+        ConcurrentSkipListMap<long, long>::Reader reader(bids);
+        assert(reader.find(10125) == 250 && !reader.contains(10150) && bids.size() == 2);
+
+        // A level flickering just below the queried keys never leaks into lookups or scans
+        std::atomic<bool> stop{false};
+        std::thread churn([&bids, &stop] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                bids.insert_or_assign(10105, 100);
+                bids.erase(10105);
+            }
+        });
+        for (int i = 0; i < 20000; ++i) {
+            assert(!reader.contains(10110));
+            std::vector<std::pair<long, long>> levels;
+            reader.range(10106, 10200, levels);
+            assert(levels.size() == 1 && levels[0].first == 10125);
+        }
+        stop.store(true, std::memory_order_relaxed);
+        churn.join();
+    }
+
+    // 30. Symbol interning - dense integer ids instead of std::string keys
+    {
+        SymbolTable symbols;
+        const SymbolId aapl = symbols.intern("AAPL");
+        const SymbolId msft = symbols.intern("MSFT");
+        assert(symbols.intern("AAPL") == aapl && msft == aapl + 1);  // Dense, first-seen order
+        assert(symbols.name(msft) == "MSFT" && !symbols.find("GOOG"));
+
+        AlignedVector<TradeSnapshot> lastTrade(symbols.size());  // Indexed directly by id
+        lastTrade[msft] = {100, 410.25, 1234567890};
+        AlignedUnorderedMap<SymbolId, double> position;          // Integer keys, trivial hash
+        position[aapl] = 1500.0;
+        assert(lastTrade[msft].price == 410.25 && position.count(aapl) == 1);
+    }
+
+    // 31. Aligned strings and pooled message builders - FIX encoding without per-message allocation
+    {
+        AlignedString account(100, 'A');  // Heap buffer starts on a cache line
+        assert(reinterpret_cast<uintptr_t>(account.data()) % CACHE_LINE_SIZE == 0);
+
+        MessageBuilderPool encoders;
+        for (long orderId = 1; orderId <= 3; ++orderId) {
+            auto msg = encoders.acquire();  // Same buffer every time once warm
+            msg->fixField(35, "D").fixField(11, orderId).fixField(55, "AAPL").fixField(44, 101.5).fixChecksum();
+            assert(msg->view().substr(0, 5) == "35=D\x01");
+        }
+    }
+
+    // 32. Columnar time series - range aggregations read only the chunks and columns they need
+    {
+        TimeSeriesStore<1024> ticks;
+        for (long t = 0; t < 4096; ++t) ticks.append(t, 100.0 + (t % 10), 10);
+        assert(ticks.chunkCount() == 4);
+
+        RangeAggregate window = ticks.aggregate(1000, 3000);  // Middle chunk answered from its zone map
+        assert(window.trades == 2000 && window.volume == 20000);
+        assert(window.chunksFromStats == 1 && window.chunksScanned == 2 && window.chunksSkipped == 1);
+        assert(window.high == 109.0 && window.low == 100.0);
+        assert(ticks.countInRange(0, 4096, 108.5, 200.0) == 409);  // Every tenth print is at 109
+    }
+
+#if !defined(_WIN32)
+    // 33. Direct I/O - page-aligned buffers written and read with O_DIRECT via batched io_uring requests
+    {
+        AlignedVector<std::byte, MEMORY_PAGE_SIZE> ticks(3 * MEMORY_PAGE_SIZE + 100);  // Partial final block
+        for (std::size_t i = 0; i < ticks.size(); ++i) ticks[i] = std::byte(i % 251);
+        const std::string path = "aligned_io_example.bin";
+        if (storeFileDirect(path, ticks)) {
+            AlignedVector<std::byte, MEMORY_PAGE_SIZE> loaded;
+            const bool reloaded = loadFileDirect(path, loaded);  // Straight into `loaded`, no page cache
+            assert(reloaded && loaded == ticks);
+
+            // Streaming: registered pool buffers, one submit for the whole batch
+            DirectIoBufferPool pool(2, MEMORY_PAGE_SIZE);
+            AlignedIoRing ring(2, &pool);
+            AlignedFile file(path, AlignedFile::Mode::Read);
+            for (unsigned i = 0; i < 2; ++i) ring.queueReadFixed(file.fd(), i, MEMORY_PAGE_SIZE, i * MEMORY_PAGE_SIZE, i);
+            ring.submit();
+            unsigned completed = ring.wait(2, [&](const AlignedIoRing::Completion& c) {
+                assert(c.result == static_cast<int>(MEMORY_PAGE_SIZE));
+                assert(pool.buffer(static_cast<unsigned>(c.tag))[1] == ticks[c.tag * MEMORY_PAGE_SIZE + 1]);
+            });
+            assert(completed == 2);
+            std::remove(path.c_str());
+        }
+    }
+#endif
+
+#if !defined(_WIN32)
+    // 34. Event journal - lock-free per-thread staging, group commit into pre-faulted mapped segments
+    {
+        const std::string base = "aligned_journal_example";
+        {
+            EventJournal journal(base, std::size_t{1} << 20);
+            EventJournal::Producer producer(journal);  // One per recording thread
+            for (int i = 1; i <= 3; ++i) producer.record(1, TradeSnapshot{100 * i, 150.25, 1234567890L + i});
+            journal.flush();  // Or journal.startFlusher() for continuous group commit
+            assert(journal.committedSequence() == 3);
+        }
+
+        long volume = 0;
+        const std::size_t replayed = EventJournal::replay(base, [&](const JournalRecordView& record) {
+            volume += record.as<TradeSnapshot>().volume;
+        });
+        assert(replayed == 3 && volume == 600);
+        std::remove(EventJournal::segmentPath(base, 0).c_str());
+    }
+#endif
+
+#if !defined(_WIN32)
+    // 35. Snapshot / restore - aligned containers written as raw page-aligned blocks, mapped back on restart
+    {
+        AlignedVector<TradeSnapshot> trades(1000, TradeSnapshot{100, 150.25, 1234567890});
+        AlignedUnorderedMap<int, double> lastPrice{{1, 150.25}, {2, 98.5}};
+        const std::string path = "aligned_snapshot_example.snap";
+
+        SnapshotWriter writer(path);
+        writer.add("trades", trades);
+        writer.add("lastPrice", lastPrice);
+        if (writer.commit()) {
+            SnapshotImage image(path);                               // mmap + manifest check
+            std::span<const TradeSnapshot> mapped = image.view<TradeSnapshot>("trades");  // Zero-copy
+            assert(mapped.size() == 1000 && reinterpret_cast<uintptr_t>(mapped.data()) % MEMORY_PAGE_SIZE == 0);
+
+            AlignedUnorderedMap<int, double> restored;
+            const bool ok = image.restore("lastPrice", restored);
+            assert(ok && restored.at(2) == 98.5);
+            assert(image.view<long>("trades").empty());  // Element layout mismatch is refused
+            std::remove(path.c_str());
+        }
+    }
+#endif
+
+    // 36. Compressed columns - delta / frame-of-reference bit packing, decoded a block at a time
+    {
+        AlignedVector<long> stamps(3000);
+        AlignedVector<double> quotes(3000);
+        for (std::size_t i = 0; i < stamps.size(); ++i) {
+            stamps[i] = 1'700'000'000'000L + static_cast<long>(i) * 250 + static_cast<long>(i % 3);
+            quotes[i] = 150.25 + static_cast<double>(i % 40) * 0.01;
+        }
+        const PackedIntColumn packedStamps(std::span<const long>(stamps), ColumnEncoding::Delta);
+        const PackedPriceColumn packedQuotes(quotes, 100);  // Cent ticks
+        assert(packedStamps.compressedBytes() * 4 < stamps.size() * sizeof(long));
+
+        alignas(CACHE_LINE_SIZE) std::int64_t stampBlock[PackedIntColumn::kBlockValues];
+        alignas(CACHE_LINE_SIZE) double quoteBlock[PackedPriceColumn::kBlockValues];
+        const std::size_t n = packedStamps.decodeBlock(2, stampBlock);  // Final, partial block
+        packedQuotes.decodeBlock(2, quoteBlock);
+        assert(n == 3000 - 2 * PackedIntColumn::kBlockValues);
+        assert(stampBlock[n - 1] == stamps.back() && quoteBlock[n - 1] == quotes.back());
+    }
+
+    // 37. Bounded-latency heap - TLSF over a caller-owned region, then as an allocator backend
+    {
+        alignas(MEMORY_PAGE_SIZE) static std::byte region[1 << 20];
+        std::memset(region, 0xFF, sizeof(region));  // The region need not be zeroed
+        TlsfHeap heap(region, sizeof(region));
+        const std::size_t initiallyFree = heap.freeBytes();
+        void* header = heap.allocate(40, 16);
+        void* page = heap.allocate(6000, MEMORY_PAGE_SIZE);  // Leading gap is split off, not wasted
+        assert(page && reinterpret_cast<std::uintptr_t>(page) % MEMORY_PAGE_SIZE == 0 && heap.owns(page));
+        heap.deallocate(header);
+        heap.deallocate(page);
+        assert(heap.freeBytes() == initiallyFree);  // Neighbours coalesced back into one block
+
+        std::vector<TradeSnapshot, TlsfAlignedAllocator<TradeSnapshot>> fills;
+        for (int i = 0; i < 100; ++i) fills.push_back(TradeSnapshot{i, 100.0 + i, i});
+        assert(reinterpret_cast<std::uintptr_t>(fills.data()) % CACHE_LINE_SIZE == 0);
+    }
+
+#if defined(ALIGNED_ALLOCATOR_BENCHMARKS)
+    bench::runAll();
+#endif
+
     return 0;
 }
+#endif